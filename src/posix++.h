@@ -15,29 +15,44 @@
 
 namespace posix {}
 
+#include "posix++/arena.h"
+#include "posix++/buffered_reader.h"
+#include "posix++/buffered_writer.h"
 #include "posix++/descriptor.h"
 #include "posix++/directory.h"
+#include "posix++/dirty_tracker.h"
 #include "posix++/error.h"
 #include "posix++/feature.h"
 #include "posix++/file.h"
 #include "posix++/group.h"
+#include "posix++/io_ring.h"
 #include "posix++/local_socket.h"
+#include "posix++/mapped_array.h"
 #include "posix++/mapped_file.h"
 #include "posix++/memory_mapping.h"
 #include "posix++/message_queue.h"
 #include "posix++/mode.h"
 #include "posix++/module.h"
 #include "posix++/named_pipe.h"
+#include "posix++/numa_policy.h"
 #include "posix++/pathname.h"
+#include "posix++/poll_set.h"
 #include "posix++/process.h"
 #include "posix++/process_group.h"
+#include "posix++/reactor.h"
+#include "posix++/result.h"
+#include "posix++/ring_buffer.h"
 #include "posix++/semaphore.h"
+#include "posix++/shared_buffer.h"
 #include "posix++/socket.h"
+#include "posix++/splice.h"
 #include "posix++/stdio.h"
+#include "posix++/string_span.h"
 #include "posix++/sysv_segment.h"
 #include "posix++/thread.h"
 #include "posix++/user.h"
 #include "posix++/version.h"
+#include "posix++/windowed_mapped_file.h"
 
 ////////////////////////////////////////////////////////////////////////////////
 
@@ -0,0 +1,102 @@
+/* This is free and unencumbered software released into the public domain. */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "arena.h"
+
+#include "error.h"
+
+#include <algorithm>  /* for std::max() */
+#include <cassert>    /* for assert() */
+#include <cstdint>    /* for std::uintptr_t */
+#include <sys/mman.h> /* for MADV_*, MAP_*, PROT_* */
+#include <unistd.h>   /* for _SC_PAGE_SIZE, sysconf() */
+#include <utility>    /* for std::swap() */
+
+#ifndef MAP_NORESERVE
+#define MAP_NORESERVE 0 /* not supported by all platforms */
+#endif
+
+using namespace posix;
+
+constexpr std::size_t arena::default_capacity;
+
+namespace {
+  std::size_t
+  round_up_to_page(const std::size_t size) noexcept {
+    const auto page_size = static_cast<std::size_t>(::sysconf(_SC_PAGE_SIZE));
+    return std::max(page_size, (size + page_size - 1) / page_size * page_size);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+arena::arena(const std::size_t capacity)
+  : _mapping{memory_mapping::anonymous(round_up_to_page(capacity),
+      PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_NORESERVE)},
+    _used{0} {}
+
+arena::arena(arena&& other) noexcept
+  : _mapping{std::move(other._mapping)},
+    _used{other._used} {
+  other._used = 0;
+}
+
+arena&
+arena::operator=(arena&& other) noexcept {
+  if (this != &other) {
+    std::swap(_mapping, other._mapping);
+    std::swap(_used, other._used);
+  }
+  return *this;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void*
+arena::allocate(const std::size_t size,
+                const std::size_t alignment) {
+  assert(alignment != 0 && (alignment & (alignment - 1)) == 0);
+
+  const auto base = reinterpret_cast<std::uintptr_t>(_mapping.data());
+  const auto start = ((base + _used + alignment - 1) & ~(alignment - 1)) - base;
+  if (start + size > capacity()) {
+    grow(start + size);
+  }
+  _used = start + size;
+  return _mapping.data(start);
+}
+
+void
+arena::deallocate(void* const pointer,
+                  const std::size_t size,
+                  const std::size_t /*alignment*/) noexcept {
+  /* Only the most recent allocation can be rolled back: */
+  if (size <= _used && pointer == _mapping.data(_used - size)) {
+    _used -= size;
+  }
+}
+
+void
+arena::release() {
+  if (_used) {
+    const std::size_t used = _used;
+    _used = 0;
+#ifdef MADV_FREE
+    try {
+      _mapping.advise(0, used, MADV_FREE);
+      return;
+    }
+    catch (const invalid_argument&) {} /* Linux < 4.5 */
+#endif
+    _mapping.advise(0, used, MADV_DONTNEED);
+  }
+}
+
+void
+arena::grow(const std::size_t min_size) {
+  /* Grow in place only, as previous allocations must stay valid: */
+  _mapping.remap(std::max(capacity() * 2, round_up_to_page(min_size)), 0);
+}
@@ -0,0 +1,238 @@
+/* This is free and unencumbered software released into the public domain. */
+
+#ifndef POSIXXX_ARENA_H
+#define POSIXXX_ARENA_H
+
+#ifndef __cplusplus
+#error "<posix++/arena.h> requires a C++ compiler"
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include "memory_mapping.h"
+
+#include <cstddef> /* for std::max_align_t, std::size_t */
+
+#if __cplusplus >= 201703L && defined(__has_include)
+#if __has_include(<memory_resource>)
+#include <memory_resource> /* for std::pmr::memory_resource */
+#define POSIXXX_ARENA_PMR 1
+#endif
+#endif
+
+namespace posix {
+  class arena;
+  template<typename T> class arena_allocator;
+#ifdef POSIXXX_ARENA_PMR
+  class arena_resource;
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * A region-based memory allocator backed by an anonymous memory mapping.
+ *
+ * A large range of address space is reserved up front without committing
+ * swap space (`MAP_NORESERVE`), so that physical pages are only consumed
+ * as they are first touched. Allocation merely bumps a cursor, and
+ * individual deallocations are no-ops (except for the most recent one),
+ * with all memory reclaimed at once by `reset()` or `release()`.
+ *
+ * Should the reservation be exhausted, the mapping is grown in place
+ * with `mremap()`; it is never moved, so that previously allocated memory
+ * stays valid.
+ *
+ * This class is not thread-safe. It is intended for per-thread or
+ * per-request scratch memory.
+ *
+ * Use `posix::arena_allocator` to allocate from the arena with the
+ * standard containers, or, in C++17 and later, `posix::arena_resource`
+ * with the `std::pmr` containers.
+ */
+class posix::arena {
+protected:
+  memory_mapping _mapping;
+  std::size_t _used;
+
+  void grow(std::size_t min_size);
+
+public:
+  /**
+   * The default amount of address space to reserve.
+   */
+  static constexpr std::size_t default_capacity = 64 * 1024 * 1024;
+
+  /**
+   * Constructor.
+   *
+   * @param capacity the amount of address space to reserve, rounded up to
+   *                 a multiple of the page size
+   * @throws posix::error on failure
+   */
+  explicit arena(std::size_t capacity = default_capacity);
+
+  /**
+   * Move constructor.
+   */
+  arena(arena&& other) noexcept;
+
+  /**
+   * Move assignment operator.
+   */
+  arena& operator=(arena&& other) noexcept;
+
+  /**
+   * Returns the number of bytes currently reserved.
+   */
+  std::size_t capacity() const noexcept {
+    return _mapping.size();
+  }
+
+  /**
+   * Returns the number of bytes allocated so far, including any padding
+   * for alignment.
+   */
+  std::size_t used() const noexcept {
+    return _used;
+  }
+
+  /**
+   * Returns the number of bytes that can be allocated before the arena
+   * needs to grow.
+   */
+  std::size_t available() const noexcept {
+    return capacity() - _used;
+  }
+
+  /**
+   * Checks whether the given pointer was allocated from this arena.
+   */
+  bool owns(const void* const pointer) const noexcept {
+    const auto* const p = reinterpret_cast<const std::uint8_t*>(pointer);
+    return p >= _mapping.data() && p < _mapping.data() + _used;
+  }
+
+  /**
+   * Allocates uninitialized memory.
+   *
+   * @param alignment the alignment, which must be a power of two
+   * @throws posix::fatal_error if the arena cannot be grown in place
+   */
+  void* allocate(std::size_t size,
+                 std::size_t alignment = alignof(std::max_align_t));
+
+  /**
+   * Deallocates memory. This only reclaims the memory if it was the most
+   * recent allocation; otherwise, it is reclaimed on `reset()`.
+   */
+  void deallocate(void* pointer, std::size_t size,
+                  std::size_t alignment = alignof(std::max_align_t)) noexcept;
+
+  /**
+   * Deallocates all memory at once, keeping the pages resident for reuse.
+   *
+   * @post `used() == 0`
+   */
+  void reset() noexcept {
+    _used = 0;
+  }
+
+  /**
+   * Deallocates all memory at once, and returns the pages to the kernel.
+   *
+   * Uses `MADV_FREE` where supported, which lets the kernel reclaim the
+   * pages lazily under memory pressure, and `MADV_DONTNEED` otherwise.
+   * The address space remains reserved.
+   *
+   * @post `used() == 0`
+   */
+  void release();
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * A standard allocator drawing from a `posix::arena`, for use with the
+ * standard containers prior to C++17.
+ */
+template<typename T>
+class posix::arena_allocator {
+  template<typename U> friend class arena_allocator;
+
+  arena* _arena;
+
+public:
+  using value_type = T;
+
+  /**
+   * Constructor.
+   */
+  arena_allocator(arena& arena) noexcept
+    : _arena{&arena} {}
+
+  /**
+   * Converting constructor.
+   */
+  template<typename U>
+  arena_allocator(const arena_allocator<U>& other) noexcept
+    : _arena{other._arena} {}
+
+  T* allocate(const std::size_t n) {
+    return static_cast<T*>(_arena->allocate(n * sizeof(T), alignof(T)));
+  }
+
+  void deallocate(T* const pointer, const std::size_t n) noexcept {
+    _arena->deallocate(pointer, n * sizeof(T), alignof(T));
+  }
+
+  template<typename U>
+  bool operator==(const arena_allocator<U>& other) const noexcept {
+    return _arena == other._arena;
+  }
+
+  template<typename U>
+  bool operator!=(const arena_allocator<U>& other) const noexcept {
+    return _arena != other._arena;
+  }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+#ifdef POSIXXX_ARENA_PMR
+/**
+ * A `std::pmr::memory_resource` drawing from a `posix::arena`.
+ *
+ * This is defined inline, so that the library itself need not be built
+ * as C++17 for it to be available.
+ */
+class posix::arena_resource : public std::pmr::memory_resource {
+  arena* _arena;
+
+public:
+  /**
+   * Constructor.
+   */
+  explicit arena_resource(arena& arena) noexcept
+    : _arena{&arena} {}
+
+protected:
+  void* do_allocate(const std::size_t size, const std::size_t alignment) override {
+    return _arena->allocate(size, alignment);
+  }
+
+  void do_deallocate(void* const pointer, const std::size_t size,
+                     const std::size_t alignment) override {
+    _arena->deallocate(pointer, size, alignment);
+  }
+
+  bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+    const auto* const resource = dynamic_cast<const arena_resource*>(&other);
+    return resource && resource->_arena == _arena;
+  }
+};
+#endif /* POSIXXX_ARENA_PMR */
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif /* POSIXXX_ARENA_H */
@@ -0,0 +1,179 @@
+/* This is free and unencumbered software released into the public domain. */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "buffered_reader.h"
+
+#include "descriptor.h"
+#include "error.h"
+
+#include <algorithm> /* for std::min() */
+#include <cassert>   /* for assert() */
+#include <cerrno>    /* for errno */
+#include <cstdint>   /* for std::uint8_t */
+#include <cstring>   /* for std::memchr(), std::memcpy() */
+#include <unistd.h>  /* for read() */
+#include <utility>   /* for std::move() */
+
+using namespace posix;
+
+constexpr std::size_t buffered_reader::default_buffer_size;
+
+buffered_reader::buffered_reader(const descriptor& source,
+                                 const std::size_t buffer_size)
+  : _source{&source},
+    _buffer(buffer_size ? buffer_size : default_buffer_size) {}
+
+buffered_reader::buffered_reader(buffered_reader&& other) noexcept
+  : _source{other._source},
+    _buffer{std::move(other._buffer)},
+    _begin{other._begin},
+    _end{other._end} {
+
+  other._buffer.clear();
+  other._begin = other._end = 0;
+}
+
+buffered_reader&
+buffered_reader::operator=(buffered_reader&& other) noexcept {
+  if (this != &other) {
+    _source = other._source;
+    _buffer = std::move(other._buffer);
+    _begin = other._begin;
+    _end = other._end;
+    other._buffer.clear();
+    other._begin = other._end = 0;
+  }
+  return *this;
+}
+
+std::string
+buffered_reader::release() {
+  std::string result(_buffer.data() + _begin, buffered());
+  _begin = _end = 0;
+  return result;
+}
+
+std::size_t
+buffered_reader::fill() {
+  assert(_begin == _end);
+
+  _begin = _end = 0;
+
+retry:
+  const ssize_t rc = ::read(_source->fd(), _buffer.data(), _buffer.size());
+  switch (rc) {
+    case -1:
+      switch (errno) {
+        case EINTR: /* Interrupted system call */
+          goto retry; /* try again */
+        default:
+          assert(errno != EFAULT);
+          throw_error("read", "%d, %s, %zu", _source->fd(), "buffer", _buffer.size());
+      }
+
+    case 0:
+      return 0; /* EOF */
+
+    default:
+      assert(rc > 0);
+      _end = static_cast<std::size_t>(rc);
+      return _end;
+  }
+}
+
+std::size_t
+buffered_reader::read_lines(std::set<std::string>& result) {
+  std::size_t total_byte_count = 0, byte_count = 0;
+  std::string line;
+  while ((byte_count = read_line(line))) {
+    total_byte_count += byte_count;
+    result.insert(line);
+    line.clear();
+  }
+  return total_byte_count;
+}
+
+std::size_t
+buffered_reader::read_line(std::string& buffer) {
+  return read_until('\n', buffer);
+}
+
+std::size_t
+buffered_reader::read_until(const char separator,
+                            std::string& buffer) {
+  std::size_t byte_count = 0;
+
+  while (_begin < _end || fill()) {
+    const char* const chunk = _buffer.data() + _begin;
+    const std::size_t chunk_size = _end - _begin;
+
+    /* std::memchr() is vectorized by all mainstream C libraries: */
+    const void* const match = std::memchr(chunk, separator, chunk_size);
+    if (match) {
+      const auto length = static_cast<std::size_t>(
+        reinterpret_cast<const char*>(match) - chunk);
+      buffer.append(chunk, length);
+      _begin += length + 1;
+      byte_count += length + 1;
+      break; /* all done */
+    }
+
+    buffer.append(chunk, chunk_size);
+    _begin = _end;
+    byte_count += chunk_size;
+  }
+
+  return byte_count;
+}
+
+std::size_t
+buffered_reader::read(char& result) {
+  if (_begin == _end && !fill()) {
+    return 0; /* EOF */
+  }
+  result = _buffer[_begin++];
+  return 1;
+}
+
+std::size_t
+buffered_reader::read(void* const buffer,
+                      const std::size_t buffer_size) {
+  assert(buffer != nullptr);
+
+  auto output = reinterpret_cast<std::uint8_t*>(buffer);
+  std::size_t byte_count = 0;
+
+  while (byte_count < buffer_size) {
+    if (_begin == _end) {
+      const std::size_t remaining = buffer_size - byte_count;
+      if (remaining >= _buffer.size()) {
+        /* Large reads bypass the buffer altogether: */
+        byte_count += _source->read(output + byte_count, remaining);
+        break; /* all done, or EOF reached */
+      }
+      if (!fill()) {
+        break; /* EOF */
+      }
+    }
+
+    const auto length = std::min(buffer_size - byte_count, _end - _begin);
+    std::memcpy(output + byte_count, _buffer.data() + _begin, length);
+    _begin += length;
+    byte_count += length;
+  }
+
+  return byte_count;
+}
+
+std::string
+buffered_reader::read() {
+  std::string result = release();
+  while (fill()) {
+    result.append(_buffer.data(), _end);
+    _begin = _end = 0;
+  }
+  return result;
+}
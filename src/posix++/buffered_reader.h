@@ -0,0 +1,151 @@
+/* This is free and unencumbered software released into the public domain. */
+
+#ifndef POSIXXX_BUFFERED_READER_H
+#define POSIXXX_BUFFERED_READER_H
+
+#ifndef __cplusplus
+#error "<posix++/buffered_reader.h> requires a C++ compiler"
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include <cstddef> /* for std::size_t */
+#include <set>     /* for std::set */
+#include <string>  /* for std::string */
+#include <vector>  /* for std::vector */
+
+namespace posix {
+  struct descriptor;
+  class buffered_reader;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * A buffered reader for a POSIX file descriptor.
+ *
+ * Refills an internal buffer with as few `read()` system calls as possible
+ * and serves line-oriented and bulk reads out of it.
+ *
+ * @note The reader does not own the descriptor, which must outlive it.
+ * @note Data buffered by the reader has already been consumed from the
+ *       descriptor. Use `release()` to reclaim it before switching back to
+ *       reading from the descriptor directly.
+ */
+class posix::buffered_reader {
+public:
+  /**
+   * The default buffer size in bytes.
+   */
+  static constexpr std::size_t default_buffer_size = 65536;
+
+  /**
+   * Constructor.
+   */
+  buffered_reader(const descriptor& source,
+                  std::size_t buffer_size = default_buffer_size);
+
+  /**
+   * Copy constructor.
+   */
+  buffered_reader(const buffered_reader& other) = delete;
+
+  /**
+   * Move constructor. Leaves `other` with no buffered data.
+   */
+  buffered_reader(buffered_reader&& other) noexcept;
+
+  /**
+   * Copy assignment operator.
+   */
+  buffered_reader& operator=(const buffered_reader& other) = delete;
+
+  /**
+   * Move assignment operator. Leaves `other` with no buffered data.
+   */
+  buffered_reader& operator=(buffered_reader&& other) noexcept;
+
+  /**
+   * Destructor.
+   */
+  ~buffered_reader() noexcept = default;
+
+  /**
+   * Returns the descriptor this reader reads from.
+   */
+  const descriptor& source() const noexcept {
+    return *_source;
+  }
+
+  /**
+   * Returns the capacity of the internal buffer in bytes.
+   */
+  std::size_t capacity() const noexcept {
+    return _buffer.size();
+  }
+
+  /**
+   * Returns the number of buffered bytes not yet consumed.
+   */
+  std::size_t buffered() const noexcept {
+    return _end - _begin;
+  }
+
+  /**
+   * Returns any buffered bytes not yet consumed, and empties the buffer.
+   *
+   * @post `buffered()` returns zero
+   */
+  std::string release();
+
+  /**
+   * Reads lines of text until EOF.
+   */
+  std::size_t read_lines(std::set<std::string>& result);
+
+  /**
+   * Reads a line of text.
+   */
+  std::size_t read_line(std::string& buffer);
+
+  /**
+   * Reads data until the given separator character is encountered.
+   *
+   * @return the number of bytes consumed, including the separator
+   */
+  std::size_t read_until(char separator, std::string& buffer);
+
+  /**
+   * Reads a character.
+   */
+  std::size_t read(char& result);
+
+  /**
+   * Reads data.
+   *
+   * Will either fill the given buffer, or stop short at EOF.
+   */
+  std::size_t read(void* buffer, std::size_t buffer_size);
+
+  /**
+   * Reads a string until EOF.
+   */
+  std::string read();
+
+protected:
+  /**
+   * Refills the empty buffer with a single `read()` call.
+   *
+   * @return the number of bytes read, or zero on EOF
+   */
+  std::size_t fill();
+
+  const descriptor* _source;
+  std::vector<char> _buffer;
+  std::size_t _begin = 0;
+  std::size_t _end = 0;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif /* POSIXXX_BUFFERED_READER_H */
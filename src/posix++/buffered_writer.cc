@@ -0,0 +1,145 @@
+/* This is free and unencumbered software released into the public domain. */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "buffered_writer.h"
+
+#include "descriptor.h"
+#include "error.h"
+
+#include <array>      /* for std::array */
+#include <cassert>    /* for assert() */
+#include <cstddef>    /* for std::ptrdiff_t */
+#include <cerrno>     /* for errno */
+#include <cstdint>    /* for std::uint8_t */
+#include <cstring>    /* for std::strlen() */
+#include <sys/uio.h>  /* for struct iovec, writev() */
+
+using namespace posix;
+
+constexpr std::size_t buffered_writer::default_buffer_size;
+
+buffered_writer::buffered_writer(const descriptor& target,
+                                 const std::size_t buffer_size)
+  : _target{&target},
+    _capacity{buffer_size ? buffer_size : default_buffer_size} {
+  _buffer.reserve(_capacity);
+}
+
+buffered_writer::~buffered_writer() noexcept {
+  try {
+    flush();
+  }
+  catch (...) {
+    /* Ignore any errors from flush(). */
+  }
+}
+
+void
+buffered_writer::write_line(const char* const data) {
+  assert(data != nullptr);
+
+  return write_line(data, std::strlen(data));
+}
+
+void
+buffered_writer::write_line(const char* const data,
+                            const std::size_t size) {
+  assert(data != nullptr);
+
+  if (size + 1 <= _capacity - _buffer.size()) {
+    _buffer.insert(_buffer.end(), data, data + size);
+    _buffer.push_back('\n');
+  }
+  else {
+    static const char newline = '\n';
+    flush(data, size, &newline, 1);
+  }
+}
+
+void
+buffered_writer::write(const char* const data) {
+  assert(data != nullptr);
+
+  return write(data, std::strlen(data));
+}
+
+void
+buffered_writer::write(const char c) {
+  if (_buffer.size() == _capacity) {
+    flush();
+  }
+  _buffer.push_back(c);
+}
+
+void
+buffered_writer::write(const void* const data,
+                       const std::size_t size) {
+  assert(data != nullptr);
+
+  if (size <= _capacity - _buffer.size()) {
+    const auto bytes = reinterpret_cast<const char*>(data);
+    _buffer.insert(_buffer.end(), bytes, bytes + size);
+  }
+  else {
+    flush(data, size);
+  }
+}
+
+void
+buffered_writer::flush() {
+  if (!_buffer.empty()) {
+    flush(nullptr, 0);
+  }
+}
+
+void
+buffered_writer::flush(const void* const data,
+                       const std::size_t size,
+                       const void* const trailer,
+                       const std::size_t trailer_size) {
+  std::array<struct iovec, 3> iov = {{
+    {_buffer.data(), _buffer.size()},
+    {const_cast<void*>(data), size},
+    {const_cast<void*>(trailer), trailer_size},
+  }};
+
+  struct iovec* pos = iov.data();
+  int count = static_cast<int>(iov.size());
+
+  while (count > 0) {
+    if (pos->iov_len == 0) {
+      pos++, count--;
+      continue; /* skip empty segments */
+    }
+
+    const ssize_t rc = ::writev(_target->fd(), pos, count);
+    if (rc == -1) {
+      switch (errno) {
+        case EINTR:  /* Interrupted system call */
+          continue;
+        default: {
+          /* Drop the buffered data already written, lest it be resent: */
+          const std::size_t unwritten = (pos == iov.data()) ? pos->iov_len : 0;
+          _buffer.erase(_buffer.begin(), _buffer.end() - static_cast<std::ptrdiff_t>(unwritten));
+          throw_error("writev", "%d, %s, %d", _target->fd(), "iov", count);
+        }
+      }
+    }
+
+    /* Resume after a partial write, which may end mid-segment: */
+    std::size_t written = static_cast<std::size_t>(rc);
+    while (count > 0 && written >= pos->iov_len) {
+      written -= pos->iov_len;
+      pos++, count--;
+    }
+    if (written) {
+      pos->iov_base = reinterpret_cast<std::uint8_t*>(pos->iov_base) + written;
+      pos->iov_len -= written;
+    }
+  }
+
+  _buffer.clear();
+}
@@ -0,0 +1,152 @@
+/* This is free and unencumbered software released into the public domain. */
+
+#ifndef POSIXXX_BUFFERED_WRITER_H
+#define POSIXXX_BUFFERED_WRITER_H
+
+#ifndef __cplusplus
+#error "<posix++/buffered_writer.h> requires a C++ compiler"
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include <cstddef> /* for std::size_t */
+#include <string>  /* for std::string */
+#include <vector>  /* for std::vector */
+
+namespace posix {
+  struct descriptor;
+  class buffered_writer;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * A write-coalescing buffered writer for a POSIX file descriptor.
+ *
+ * Accumulates small writes in a user-space buffer, and hands them to the
+ * kernel with a single `writev()` system call when the buffer fills up,
+ * on an explicit `flush()`, or on destruction.
+ *
+ * @note The writer does not own the descriptor, which must outlive it.
+ */
+class posix::buffered_writer {
+public:
+  /**
+   * The default buffer size in bytes.
+   */
+  static constexpr std::size_t default_buffer_size = 65536;
+
+  /**
+   * Constructor.
+   */
+  buffered_writer(const descriptor& target,
+                  std::size_t buffer_size = default_buffer_size);
+
+  /**
+   * Copy constructor.
+   */
+  buffered_writer(const buffered_writer& other) = delete;
+
+  /**
+   * Move constructor.
+   */
+  buffered_writer(buffered_writer&& other) noexcept = default;
+
+  /**
+   * Copy assignment operator.
+   */
+  buffered_writer& operator=(const buffered_writer& other) = delete;
+
+  /**
+   * Move assignment operator.
+   */
+  buffered_writer& operator=(buffered_writer&& other) = delete;
+
+  /**
+   * Destructor. Invokes `flush()`, ignoring any errors.
+   */
+  ~buffered_writer() noexcept;
+
+  /**
+   * Returns the descriptor this writer writes to.
+   */
+  const descriptor& target() const noexcept {
+    return *_target;
+  }
+
+  /**
+   * Returns the capacity of the internal buffer in bytes.
+   */
+  std::size_t capacity() const noexcept {
+    return _capacity;
+  }
+
+  /**
+   * Returns the number of buffered bytes not yet written.
+   */
+  std::size_t buffered() const noexcept {
+    return _buffer.size();
+  }
+
+  /**
+   * Writes a line.
+   */
+  inline void write_line(const std::string& string) {
+    write_line(string.data(), string.size());
+  }
+
+  /**
+   * Writes a line.
+   */
+  void write_line(const char* data);
+
+  /**
+   * Writes a line.
+   */
+  void write_line(const char* data, std::size_t size);
+
+  /**
+   * Writes a string.
+   */
+  inline void write(const std::string& string) {
+    write(string.data(), string.size());
+  }
+
+  /**
+   * Writes data.
+   */
+  void write(const char* data);
+
+  /**
+   * Writes a character.
+   */
+  void write(char c);
+
+  /**
+   * Writes data.
+   *
+   * Data that does not fit into the remaining buffer space is written
+   * together with the buffer contents using a single `writev()` call.
+   */
+  void write(const void* data, std::size_t size);
+
+  /**
+   * Writes all buffered data to the descriptor.
+   *
+   * Retries the operation automatically in case of partial writes or an
+   * `EINTR` (interrupted system call) error.
+   */
+  void flush();
+
+protected:
+  void flush(const void* data, std::size_t size,
+             const void* trailer = nullptr, std::size_t trailer_size = 0);
+
+  const descriptor* _target;
+  std::size_t _capacity;
+  std::vector<char> _buffer;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif /* POSIXXX_BUFFERED_WRITER_H */
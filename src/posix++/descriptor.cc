@@ -8,23 +8,48 @@
 
 #include "error.h"
 #include "group.h"
+#include "iov.h"
 #include "mode.h"
+#include "splice.h"
 #include "user.h"
 
+#include <algorithm>  /* for std::min() */
 #include <array>      /* for std::array */
 #include <cassert>    /* for assert() */
 #include <cerrno>     /* for errno */
 #include <cstdint>    /* for std::uint8_t */
 #include <cstring>    /* for std::strlen() */
-#include <fcntl.h>    /* for F_*, fcntl() */
+#include <fcntl.h>    /* for F_*, SPLICE_F_*, fcntl() */
 #include <poll.h>     /* for struct pollfd, poll() */
 #include <stdexcept>  /* for std::invalid_argument */
 #include <string>     /* for std::string */
-#include <sys/stat.h> /* for fchmod() */
+#include <sys/stat.h> /* for S_ISFIFO(), fchmod(), fstat() */
+#include <sys/uio.h>  /* for struct iovec, preadv*(), pwritev*(), readv(), writev() */
 #include <unistd.h>   /* for close(), fchown(), fsync(), read(), write() */
+#include <vector>     /* for std::vector */
 
 using namespace posix;
 
+namespace {
+  static int iov_count(const std::size_t iovcnt) {
+    return static_cast<int>(std::min(iovcnt, iov_max));
+  }
+
+  /* The maximum number of bytes per transfer_to() iteration: */
+  static const std::size_t transfer_chunk_size = 65536;
+
+#ifdef __linux__
+  static bool is_pipe(const int fd) {
+    struct stat st;
+    return fstat(fd, &st) == 0 && S_ISFIFO(st.st_mode);
+  }
+
+  static bool is_unsupported(const posix::error& error) {
+    return error.number() == EINVAL || error.number() == ENOSYS;
+  }
+#endif
+}
+
 static const std::string invalid_in_copy_constructor =
   "invalid descriptor passed to copy constructor";
 
@@ -169,7 +194,11 @@ void
 descriptor::write_line(const char* const data) {
   assert(data != nullptr);
 
-  return write(data), write('\n');
+  const struct iovec iov[2] = {
+    {const_cast<char*>(data), std::strlen(data)},
+    {const_cast<char*>("\n"), 1},
+  };
+  return write(iov, 2);
 }
 
 void
@@ -205,6 +234,94 @@ descriptor::write(const void* const data,
   }
 }
 
+result<std::size_t>
+descriptor::try_write(const void* const data,
+                      const std::size_t size) noexcept {
+  assert(data != nullptr || size == 0);
+
+retry:
+  const ssize_t rc = ::write(fd(), data, size);
+  if (rc == -1) {
+    switch (errno) {
+      case EINTR: /* Interrupted system call */
+        goto retry;
+      default:
+        return result<std::size_t>::from_errno();
+    }
+  }
+  return static_cast<std::size_t>(rc);
+}
+
+void
+descriptor::write(const struct iovec* const iov,
+                  const std::size_t iovcnt) {
+  assert(iov != nullptr || iovcnt == 0);
+
+  std::size_t index = 0;
+  while (index < iovcnt) {
+    const int count = iov_count(iovcnt - index);
+    const ssize_t rc = ::writev(fd(), iov + index, count);
+    if (rc == -1) {
+      switch (errno) {
+        case EINTR:  /* Interrupted system call */
+          continue;
+        default:
+          throw_error("writev", "%d, %s, %d", fd(), "iov", count);
+      }
+    }
+
+    /* Skip past the buffers that were written in full: */
+    std::size_t written = static_cast<std::size_t>(rc);
+    while (index < iovcnt && written >= iov[index].iov_len) {
+      written -= iov[index].iov_len;
+      index++;
+    }
+
+    /* Finish off a partially written buffer before resuming: */
+    if (written) {
+      write(reinterpret_cast<const std::uint8_t*>(iov[index].iov_base) + written,
+        iov[index].iov_len - written);
+      index++;
+    }
+  }
+}
+
+std::size_t
+descriptor::pwrite(const struct iovec* const iov,
+                   const std::size_t iovcnt,
+                   const off_t offset,
+                   const int flags) {
+  assert(iov != nullptr || iovcnt == 0);
+
+  const int count = iov_count(iovcnt);
+retry:
+#if defined(HAVE_PWRITEV2)
+  static const char* const origin = "pwritev2";
+  const ssize_t rc = ::pwritev2(fd(), iov, count, offset, flags);
+#elif defined(HAVE_PWRITEV)
+  static const char* const origin = "pwritev";
+  if (flags) {
+    throw_error(ENOSYS); /* Function not implemented */
+  }
+  const ssize_t rc = ::pwritev(fd(), iov, count, offset);
+#else
+  static const char* const origin = "pwritev2";
+  (void)count, (void)offset, (void)flags; /* not used */
+  const ssize_t rc = -1;
+  errno = ENOSYS; /* Function not implemented */
+#endif
+  if (rc == -1) {
+    switch (errno) {
+      case EINTR:  /* Interrupted system call */
+        goto retry;
+      default:
+        throw_error(origin, "%d, %s, %d, 0x%lx, 0x%x", fd(), "iov", count,
+          static_cast<unsigned long>(offset), static_cast<unsigned int>(flags));
+    }
+  }
+  return static_cast<std::size_t>(rc);
+}
+
 std::size_t
 descriptor::read_lines(std::set<std::string>& result) const {
   std::size_t total_byte_count = 0, byte_count = 0;
@@ -297,6 +414,113 @@ exit:
   return byte_count;
 }
 
+result<std::size_t>
+descriptor::try_read(void* const buffer,
+                     const std::size_t buffer_size) const noexcept {
+  assert(buffer != nullptr || buffer_size == 0);
+
+retry:
+  const ssize_t rc = ::read(fd(), buffer, buffer_size);
+  if (rc == -1) {
+    switch (errno) {
+      case EINTR: /* Interrupted system call */
+        goto retry;
+      default:
+        return result<std::size_t>::from_errno();
+    }
+  }
+  return static_cast<std::size_t>(rc);
+}
+
+std::size_t
+descriptor::read(const struct iovec* const iov,
+                 const std::size_t iovcnt) const {
+  assert(iov != nullptr || iovcnt == 0);
+
+  std::size_t byte_count = 0;
+
+  std::size_t index = 0;
+  while (index < iovcnt) {
+    const int count = iov_count(iovcnt - index);
+    const ssize_t rc = ::readv(fd(), iov + index, count);
+    switch (rc) {
+      case -1:
+        switch (errno) {
+          case EINTR: /* Interrupted system call */
+            continue; /* try again */
+          default:
+            throw_error("readv", "%d, %s, %d", fd(), "iov", count);
+        }
+
+      case 0:
+        goto exit; /* end of file */
+
+      default:
+        assert(rc > 0);
+        break;
+    }
+
+    /* Skip past the buffers that were filled in full: */
+    std::size_t chunk_size = static_cast<std::size_t>(rc);
+    byte_count += chunk_size;
+    while (index < iovcnt && chunk_size >= iov[index].iov_len) {
+      chunk_size -= iov[index].iov_len;
+      index++;
+    }
+
+    /* Finish off a partially filled buffer before resuming: */
+    if (chunk_size) {
+      const std::size_t remaining = iov[index].iov_len - chunk_size;
+      const std::size_t read_size =
+        read(reinterpret_cast<std::uint8_t*>(iov[index].iov_base) + chunk_size, remaining);
+      byte_count += read_size;
+      if (read_size < remaining) {
+        goto exit; /* end of file */
+      }
+      index++;
+    }
+  }
+
+exit:
+  return byte_count;
+}
+
+std::size_t
+descriptor::pread(const struct iovec* const iov,
+                  const std::size_t iovcnt,
+                  const off_t offset,
+                  const int flags) const {
+  assert(iov != nullptr || iovcnt == 0);
+
+  const int count = iov_count(iovcnt);
+retry:
+#if defined(HAVE_PREADV2)
+  static const char* const origin = "preadv2";
+  const ssize_t rc = ::preadv2(fd(), iov, count, offset, flags);
+#elif defined(HAVE_PREADV)
+  static const char* const origin = "preadv";
+  if (flags) {
+    throw_error(ENOSYS); /* Function not implemented */
+  }
+  const ssize_t rc = ::preadv(fd(), iov, count, offset);
+#else
+  static const char* const origin = "preadv2";
+  (void)count, (void)offset, (void)flags; /* not used */
+  const ssize_t rc = -1;
+  errno = ENOSYS; /* Function not implemented */
+#endif
+  if (rc == -1) {
+    switch (errno) {
+      case EINTR: /* Interrupted system call */
+        goto retry;
+      default:
+        throw_error(origin, "%d, %s, %d, 0x%lx, 0x%x", fd(), "iov", count,
+          static_cast<unsigned long>(offset), static_cast<unsigned int>(flags));
+    }
+  }
+  return static_cast<std::size_t>(rc);
+}
+
 std::string
 descriptor::read() const {
   std::string result;
@@ -324,6 +548,63 @@ descriptor::read() const {
   }
 }
 
+std::size_t
+descriptor::transfer_to(descriptor& target,
+                        const std::size_t length) const {
+  std::size_t byte_count = 0;
+
+#ifdef __linux__
+  if (is_pipe(fd()) || is_pipe(target.fd())) {
+    try {
+      while (byte_count < length) {
+        const std::size_t chunk_size = posix::splice(*this, target,
+          std::min(length - byte_count, transfer_chunk_size), SPLICE_F_MOVE);
+        if (!chunk_size) {
+          return byte_count; /* EOF */
+        }
+        byte_count += chunk_size;
+      }
+      return byte_count;
+    }
+    catch (const posix::logic_error& error) {
+      if (!is_unsupported(error)) throw;
+      /* Fall back to read()/write() below. */
+    }
+  }
+  else {
+    /* Neither side is a pipe, so relay through an intermediate one: */
+    if (posix::splice_through_pipe(*this, nullptr, target, length, byte_count)) {
+      return byte_count;
+    }
+    /* Fall back to read()/write() below. */
+  }
+#endif /* __linux__ */
+
+  std::vector<std::uint8_t> buffer(transfer_chunk_size);
+  while (byte_count < length) {
+    const std::size_t chunk_size = std::min(length - byte_count, buffer.size());
+    const ssize_t rc = ::read(fd(), buffer.data(), chunk_size);
+    switch (rc) {
+      case -1:
+        switch (errno) {
+          case EINTR: /* Interrupted system call */
+            continue; /* try again */
+          default:
+            throw_error("read", "%d, %s, %zu", fd(), "buffer", chunk_size);
+        }
+
+      case 0:
+        return byte_count; /* EOF */
+
+      default:
+        assert(rc > 0);
+        target.write(buffer.data(), static_cast<std::size_t>(rc));
+        byte_count += static_cast<std::size_t>(rc);
+    }
+  }
+  return byte_count;
+}
+
 void
 descriptor::sync() {
   if (fsync(_fd) == -1) {
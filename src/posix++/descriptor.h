@@ -10,11 +10,15 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 #include "mode.h"
+#include "result.h"
 
-#include <cstddef> /* for std::size_t */
-#include <set>     /* for std::set */
-#include <string>  /* for std::string */
-#include <utility> /* for std::swap() */
+#include <cstddef>     /* for std::size_t */
+#include <set>         /* for std::set */
+#include <string>      /* for std::string */
+#include <sys/types.h> /* for off_t */
+#include <utility>     /* for std::swap() */
+
+struct iovec; // @see <sys/uio.h>
 
 namespace posix {
   struct descriptor;
@@ -207,6 +211,7 @@ public:
   void chmod(const mode mode);
 
   /**
+   * @note To wait on several descriptors at once, use `posix::poll_set`.
    * @see http://pubs.opengroup.org/onlinepubs/9699919799/functions/poll.html
    */
   bool poll(short events, short* revents = nullptr, int timeout = -1);
@@ -250,6 +255,46 @@ public:
    */
   void write(const void* data, std::size_t size);
 
+  /**
+   * Writes data to this descriptor with a single `write()` call, which
+   * may write less than `size` bytes.
+   *
+   * Retries the operation automatically in case an `EINTR`
+   * (interrupted system call) error is encountered.
+   *
+   * @return the number of bytes written, or the error code on failure
+   *         (e.g. `EAGAIN` for a non-blocking descriptor)
+   */
+  result<std::size_t> try_write(const void* data, std::size_t size) noexcept;
+
+  /**
+   * Writes data from multiple buffers to this descriptor (gather output).
+   *
+   * Will either write all the given data, or throw an error.
+   *
+   * Resumes automatically after partial writes, including those ending
+   * in the middle of a buffer, and retries the operation in case an
+   * `EINTR` (interrupted system call) error is encountered.
+   *
+   * @see http://pubs.opengroup.org/onlinepubs/9699919799/functions/writev.html
+   */
+  void write(const struct iovec* iov, std::size_t iovcnt);
+
+  /**
+   * Writes data from multiple buffers at the given file offset, without
+   * changing the current file offset.
+   *
+   * The `flags` argument accepts the Linux-specific `RWF_*` flags, such as
+   * `RWF_DSYNC`, `RWF_HIPRI`, or `RWF_NOWAIT`.
+   *
+   * @return the number of bytes written, which may be less than requested
+   * @throws posix::logic_error with `ENOSYS` if `flags` is nonzero and the
+   *         platform does not support `pwritev2()`
+   * @see http://man7.org/linux/man-pages/man2/pwritev2.2.html
+   */
+  std::size_t pwrite(const struct iovec* iov, std::size_t iovcnt,
+    off_t offset, int flags = 0);
+
   /**
    * Reads lines of text from this descriptor until EOF.
    */
@@ -263,6 +308,9 @@ public:
   /**
    * Reads data from this descriptor until the given separator character
    * is encountered.
+   *
+   * @note Reads one byte per system call so as to never consume data past
+   *       the separator; prefer `posix::buffered_reader` for bulk input.
    */
   std::size_t read_until(char separator, std::string& buffer) const;
 
@@ -276,11 +324,66 @@ public:
    */
   std::size_t read(void* buffer, std::size_t buffer_size) const;
 
+  /**
+   * Reads data from this descriptor with a single `read()` call, which
+   * may read less than `buffer_size` bytes.
+   *
+   * Retries the operation automatically in case an `EINTR`
+   * (interrupted system call) error is encountered.
+   *
+   * @return the number of bytes read, zero on EOF, or the error code on
+   *         failure (e.g. `EAGAIN` for a non-blocking descriptor)
+   */
+  result<std::size_t> try_read(void* buffer, std::size_t buffer_size) const noexcept;
+
+  /**
+   * Reads data from this descriptor into multiple buffers (scatter input).
+   *
+   * Will either fill all the given buffers, or stop short at EOF.
+   *
+   * Resumes automatically after partial reads, including those ending
+   * in the middle of a buffer, and retries the operation in case an
+   * `EINTR` (interrupted system call) error is encountered.
+   *
+   * @see http://pubs.opengroup.org/onlinepubs/9699919799/functions/readv.html
+   */
+  std::size_t read(const struct iovec* iov, std::size_t iovcnt) const;
+
+  /**
+   * Reads data into multiple buffers from the given file offset, without
+   * changing the current file offset.
+   *
+   * The `flags` argument accepts the Linux-specific `RWF_*` flags, such as
+   * `RWF_HIPRI` or `RWF_NOWAIT`.
+   *
+   * @return the number of bytes read, which may be less than requested
+   * @throws posix::logic_error with `ENOSYS` if `flags` is nonzero and the
+   *         platform does not support `preadv2()`
+   * @see http://man7.org/linux/man-pages/man2/preadv2.2.html
+   */
+  std::size_t pread(const struct iovec* iov, std::size_t iovcnt,
+    off_t offset, int flags = 0) const;
+
   /**
    * Reads a string from this descriptor.
    */
   std::string read() const;
 
+  /**
+   * Transfers data from this descriptor to the given target descriptor,
+   * until EOF or until `length` bytes have been transferred.
+   *
+   * Uses `splice()` to keep the data entirely in the kernel where
+   * possible, relaying through an intermediate pipe when neither side is
+   * a pipe. Falls back to a `read()`/`write()` loop where splicing is not
+   * supported.
+   *
+   * @return the number of bytes transferred
+   * @throws posix::error on failure
+   */
+  std::size_t transfer_to(descriptor& target,
+    std::size_t length = static_cast<std::size_t>(-1)) const;
+
   /**
    * ...
    */
@@ -0,0 +1,62 @@
+/* This is free and unencumbered software released into the public domain. */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "dirty_tracker.h"
+
+#include <algorithm> /* for std::max(), std::min() */
+#include <iterator>  /* for std::prev() */
+#include <unistd.h>  /* for _SC_PAGE_SIZE, sysconf() */
+
+using namespace posix;
+
+dirty_tracker::dirty_tracker(memory_mapping& mapping)
+  : _mapping{&mapping},
+    _page_size{static_cast<std::size_t>(::sysconf(_SC_PAGE_SIZE))},
+    _dirty_size{0} {}
+
+bool
+dirty_tracker::is_dirty(const std::size_t offset) const noexcept {
+  auto next = _ranges.upper_bound(offset);
+  return next != _ranges.begin() && offset < std::prev(next)->second;
+}
+
+void
+dirty_tracker::mark(const std::size_t offset,
+                    const std::size_t length) {
+  if (offset >= _mapping->size() || !length) {
+    return; /* nothing to do */
+  }
+
+  /* Widen the range to page boundaries, clamped to the mapping: */
+  std::size_t start = offset - offset % _page_size;
+  std::size_t end = offset + std::min(length, _mapping->size() - offset);
+  end = std::min((end + _page_size - 1) / _page_size * _page_size, _mapping->size());
+
+  /* Coalesce with any overlapping or adjacent ranges: */
+  auto it = _ranges.upper_bound(start);
+  if (it != _ranges.begin() && std::prev(it)->second >= start) {
+    --it;
+  }
+  while (it != _ranges.end() && it->first <= end) {
+    start = std::min(start, it->first);
+    end = std::max(end, it->second);
+    _dirty_size -= it->second - it->first;
+    it = _ranges.erase(it);
+  }
+
+  _ranges.emplace(start, end);
+  _dirty_size += end - start;
+}
+
+void
+dirty_tracker::flush(const int flags) {
+  while (!_ranges.empty()) {
+    const auto range = _ranges.begin();
+    _mapping->sync(range->first, range->second - range->first, flags);
+    _dirty_size -= range->second - range->first;
+    _ranges.erase(range);
+  }
+}
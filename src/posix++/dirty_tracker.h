@@ -0,0 +1,100 @@
+/* This is free and unencumbered software released into the public domain. */
+
+#ifndef POSIXXX_DIRTY_TRACKER_H
+#define POSIXXX_DIRTY_TRACKER_H
+
+#ifndef __cplusplus
+#error "<posix++/dirty_tracker.h> requires a C++ compiler"
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include "memory_mapping.h"
+
+#include <cstddef> /* for std::size_t */
+#include <map>     /* for std::map */
+
+namespace posix {
+  class dirty_tracker;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Records which pages of a writable memory mapping have been written to,
+ * so that they can be flushed with the fewest `msync()` calls possible.
+ *
+ * Written ranges are widened to page boundaries and kept as a set of
+ * disjoint intervals, with adjacent and overlapping intervals coalesced.
+ * Flushing thus costs one `msync()` call per contiguous run of dirty
+ * pages, regardless of the size of the mapping.
+ *
+ * @note This class does not detect writes by itself; they must be
+ *       reported with `mark()`.
+ */
+class posix::dirty_tracker {
+protected:
+  memory_mapping* _mapping;
+  std::size_t _page_size;
+  std::size_t _dirty_size;
+  std::map<std::size_t, std::size_t> _ranges; /* start => end */
+
+public:
+  /**
+   * Constructor.
+   */
+  explicit dirty_tracker(memory_mapping& mapping);
+
+  /**
+   * Checks whether no pages are dirty.
+   */
+  bool empty() const noexcept {
+    return _ranges.empty();
+  }
+
+  /**
+   * Returns the number of disjoint dirty page ranges, i.e., the number of
+   * `msync()` calls the next `flush()` will make.
+   */
+  std::size_t range_count() const noexcept {
+    return _ranges.size();
+  }
+
+  /**
+   * Returns the total byte size of the dirty pages.
+   */
+  std::size_t dirty_size() const noexcept {
+    return _dirty_size;
+  }
+
+  /**
+   * Checks whether the page containing the given offset is dirty.
+   */
+  bool is_dirty(std::size_t offset) const noexcept;
+
+  /**
+   * Records a write to the given range of the mapping.
+   */
+  void mark(std::size_t offset, std::size_t length);
+
+  /**
+   * Flushes the dirty pages back to the mapped file, and forgets them.
+   *
+   * @param flags the `MS_*` flags, as for `memory_mapping::sync()`
+   * @throws posix::error on failure, in which case the ranges not yet
+   *         flushed remain dirty
+   */
+  void flush(int flags = MS_SYNC);
+
+  /**
+   * Forgets all dirty pages without flushing them.
+   */
+  void clear() noexcept {
+    _ranges.clear();
+    _dirty_size = 0;
+  }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif /* POSIXXX_DIRTY_TRACKER_H */
@@ -6,18 +6,264 @@
 
 #include "error.h"
 
-#include <array>   /* for std::array */
-#include <cassert> /* for assert() */
-#include <cerrno>  /* for E*, errno */
-#include <cstdarg> /* for va_*() */
-#include <cstdio>  /* for std::snprintf() */
-#include <cstring> /* for stpncpy() */
+#include <algorithm> /* for std::max(), std::min() */
+#include <array>     /* for std::array */
+#include <cerrno>    /* for E*, errno */
+#include <cstdarg>   /* for va_*() */
+#include <cstddef>   /* for std::ptrdiff_t, std::size_t */
+#include <cstdint>   /* for std::intmax_t */
+#include <cstdio>    /* for std::vsnprintf() */
+#include <cstring>   /* for std::strchr(), std::strlen(), std::strspn(), strnlen() */
+#include <memory>    /* for std::make_shared() */
+#include <mutex>     /* for std::call_once(), std::once_flag */
+#include <string>    /* for std::string */
+#include <vector>    /* for std::vector */
 
 using namespace posix;
 
+namespace {
+  /* The longest "origin(arguments" prefix of a message, and `%s` argument: */
+  static constexpr std::size_t max_length = 4095;
+
+  /**
+   * The type in which a `printf()` argument is passed.
+   */
+  enum class argument_type : char {
+    int_, long_, long_long, intmax, size, ptrdiff, double_, long_double, pointer, string, unknown,
+  };
+
+  /**
+   * Parses the conversion specification following a '%', returning its
+   * end, the number of `*` width and precision arguments, and the type.
+   */
+  static const char*
+  parse_conversion(const char* spec,
+                   int& stars,
+                   argument_type& type) noexcept {
+    stars = 0;
+    spec += std::strspn(spec, "-+ #0'");
+    if (*spec == '*') stars++, spec++;
+    else spec += std::strspn(spec, "0123456789");
+    if (*spec == '.') {
+      spec++;
+      if (*spec == '*') stars++, spec++;
+      else spec += std::strspn(spec, "0123456789");
+    }
+
+    const char length = (*spec && std::strchr("hljztL", *spec)) ? *spec++ : '\0';
+    const bool twice = (length == 'h' || length == 'l') && *spec == length;
+    if (twice) spec++;
+
+    switch (*spec) {
+      case 'c': case 'd': case 'i': case 'o': case 'u': case 'x': case 'X':
+        switch (length) {
+          case 'l': type = twice ? argument_type::long_long : argument_type::long_; break;
+          case 'j': type = argument_type::intmax; break;
+          case 'z': type = argument_type::size; break;
+          case 't': type = argument_type::ptrdiff; break;
+          default:  type = argument_type::int_; break; /* also `h`, `hh` */
+        }
+        break;
+      case 'a': case 'A': case 'e': case 'E': case 'f': case 'F': case 'g': case 'G':
+        type = (length == 'L') ? argument_type::long_double : argument_type::double_;
+        break;
+      case 'p': type = argument_type::pointer; break;
+      case 's': type = argument_type::string; break;
+      default:  type = argument_type::unknown; break; /* also `n` */
+    }
+    return *spec ? spec + 1 : spec;
+  }
+
+  /**
+   * A fixed-size buffer that `printf()` output is truncated to fit.
+   */
+  struct bounded_buffer {
+    std::array<char, max_length + 1> data;
+    std::size_t size{0};
+
+    void printf(const char* format, ...) noexcept {
+      va_list args;
+      va_start(args, format);
+      const int length = std::vsnprintf(data.data() + size, data.size() - size, format, args);
+      va_end(args);
+      size = std::min(size + static_cast<std::size_t>(std::max(length, 0)), max_length);
+    }
+  };
+}
+
+/**
+ * The origin and arguments of an error, captured when it is raised and
+ * formatted upon the first call to `error::what()`.
+ */
+struct posix::error::context {
+  struct argument {
+    argument_type type;
+    int stars;    /* the number of `*` arguments */
+    int star[2];  /* the `*` field width and precision */
+    union {
+      int i;
+      long l;
+      long long ll;
+      std::intmax_t j;
+      std::size_t z;
+      std::ptrdiff_t t;
+      double d;
+      long double ld;
+      const void* p;
+      std::size_t s; /* the offset into `strings` */
+    };
+  };
+
+  context(const char* origin, const char* format, va_list args);
+
+  const char* what(const char* message) const noexcept;
+
+  void format(bounded_buffer& output) const;
+
+  template <typename T>
+  static void print(bounded_buffer& output, const char* spec, const argument& arg, T value) noexcept {
+    switch (arg.stars) {
+      case 0:  return output.printf(spec, value);
+      case 1:  return output.printf(spec, arg.star[0], value);
+      default: return output.printf(spec, arg.star[0], arg.star[1], value);
+    }
+  }
+
+  const char* origin;
+  const char* format_;
+  const char* format_end;         /* where capturing the arguments stopped */
+  std::vector<argument> arguments;
+  std::string strings;            /* copies of the `%s` arguments */
+  mutable std::once_flag formatted;
+  mutable std::string message;    /* the formatted message, if any */
+};
+
+error::context::context(const char* const origin,
+                        const char* const format,
+                        va_list args)
+  : origin{origin},
+    format_{format},
+    format_end{format ? format + std::strlen(format) : nullptr} {
+
+  for (const char* pos = format; pos && (pos = std::strchr(pos, '%')); ) {
+    if (pos[1] == '%') {
+      pos += 2;
+      continue;
+    }
+
+    argument arg;
+    const char* const end = parse_conversion(pos + 1, arg.stars, arg.type);
+    if (arg.type == argument_type::unknown) {
+      format_end = pos; /* can't tell how to skip over its argument */
+      break;
+    }
+    for (int i = 0; i < arg.stars; i++) {
+      arg.star[i] = va_arg(args, int);
+    }
+
+    switch (arg.type) {
+      case argument_type::int_:        arg.i = va_arg(args, int); break;
+      case argument_type::long_:       arg.l = va_arg(args, long); break;
+      case argument_type::long_long:   arg.ll = va_arg(args, long long); break;
+      case argument_type::intmax:      arg.j = va_arg(args, std::intmax_t); break;
+      case argument_type::size:        arg.z = va_arg(args, std::size_t); break;
+      case argument_type::ptrdiff:     arg.t = va_arg(args, std::ptrdiff_t); break;
+      case argument_type::double_:     arg.d = va_arg(args, double); break;
+      case argument_type::long_double: arg.ld = va_arg(args, long double); break;
+      case argument_type::pointer:     arg.p = va_arg(args, const void*); break;
+      case argument_type::string: {
+        /* The string may not outlive the stack frame that raised the error: */
+        const char* const string = va_arg(args, const char*);
+        arg.s = strings.size();
+        if (string) {
+          strings.append(string, ::strnlen(string, max_length));
+        }
+        else {
+          strings.append("(null)");
+        }
+        strings.push_back('\0');
+        break;
+      }
+      case argument_type::unknown: break;
+    }
+    arguments.push_back(arg);
+    pos = end;
+  }
+}
+
+void
+error::context::format(bounded_buffer& output) const {
+  output.printf("%s(", origin);
+
+  std::size_t index = 0;
+  for (const char* pos = format_; pos && pos < format_end; ) {
+    const char* percent = std::strchr(pos, '%');
+    if (!percent || percent > format_end) {
+      percent = format_end;
+    }
+    output.printf("%.*s", static_cast<int>(percent - pos), pos);
+    if (percent == format_end) {
+      break;
+    }
+    if (percent[1] == '%') {
+      output.printf("%%");
+      pos = percent + 2;
+      continue;
+    }
+
+    int stars;
+    argument_type type;
+    const char* const end = parse_conversion(percent + 1, stars, type);
+    const std::string spec{percent, end};
+
+    const argument& arg = arguments[index++];
+    switch (arg.type) {
+      case argument_type::int_:        print(output, spec.c_str(), arg, arg.i); break;
+      case argument_type::long_:       print(output, spec.c_str(), arg, arg.l); break;
+      case argument_type::long_long:   print(output, spec.c_str(), arg, arg.ll); break;
+      case argument_type::intmax:      print(output, spec.c_str(), arg, arg.j); break;
+      case argument_type::size:        print(output, spec.c_str(), arg, arg.z); break;
+      case argument_type::ptrdiff:     print(output, spec.c_str(), arg, arg.t); break;
+      case argument_type::double_:     print(output, spec.c_str(), arg, arg.d); break;
+      case argument_type::long_double: print(output, spec.c_str(), arg, arg.ld); break;
+      case argument_type::pointer:     print(output, spec.c_str(), arg, arg.p); break;
+      case argument_type::string:      print(output, spec.c_str(), arg, strings.data() + arg.s); break;
+      case argument_type::unknown:     break;
+    }
+    pos = end;
+  }
+}
+
+const char*
+error::context::what(const char* const message) const noexcept {
+  try {
+    std::call_once(formatted, [this, message] {
+      try {
+        bounded_buffer output;
+        format(output);
+        std::string result{output.data.data(), output.size};
+        result.append("): ");
+        result.append(message);
+        this->message.swap(result);
+      }
+      catch (...) {} /* out of memory; fall back to the bare message */
+    });
+  }
+  catch (...) {}
+  return this->message.empty() ? message : this->message.c_str();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 error::error() noexcept
   : std::system_error{errno, std::system_category()} {}
 
+const char*
+error::what() const noexcept {
+  const char* const message = std::system_error::what();
+  return _context ? _context->what(message) : message;
+}
+
 bad_descriptor::bad_descriptor() noexcept
   : logic_error{EBADF} {}
 
@@ -78,57 +324,35 @@ posix::throw_error(const int code,
                    const char* const origin,
                    const char* const format,
                    va_list args) {
-  static thread_local std::array<char, 4096> buffer;
-
-  const char* what = nullptr;
-  if (!origin) {
-    what = nullptr;
-    buffer.data()[0] = '\0';
-  }
-  else {
-    what = buffer.data();
-
-    auto buffer_offset = std::snprintf(buffer.data(), buffer.size(), "%s(", origin);
-    assert(buffer_offset < buffer.size());
-
-    if (format) { // FIXME: better buffer overflow handling.
-      buffer_offset += std::vsnprintf(buffer.data() + buffer_offset, buffer.size() - buffer_offset, format, args);
-      assert(buffer_offset < buffer.size());
+  /* Capture the arguments, deferring their formatting to what(): */
+  std::shared_ptr<const error::context> context;
+  if (origin) {
+    try {
+      context = std::make_shared<const error::context>(origin, format, args);
     }
-
-    buffer.data()[buffer_offset++] = ')';
-    assert(buffer_offset < buffer.size());
-
-    buffer.data()[buffer_offset++] = '\0';
+    catch (...) {} /* out of memory; throw the error without context */
   }
 
   switch (code) {
     case EBADF:        /* Bad file descriptor */
-      throw !what ? bad_descriptor{} : bad_descriptor{what};
+      throw error::attach(bad_descriptor{}, std::move(context));
     case ECONNREFUSED: /* Connection refused */
-      throw !what ? connection_refused{} : connection_refused{what};
+      throw error::attach(connection_refused{}, std::move(context));
     case EFAULT:       /* Bad address */
-      throw !what ? bad_address{} : bad_address{what};
+      throw error::attach(bad_address{}, std::move(context));
     case EINVAL:       /* Invalid argument */
-      throw !what ? invalid_argument{} : invalid_argument{what};
+      throw error::attach(invalid_argument{}, std::move(context));
     case EMFILE:       /* Too many open files */
-      throw !what ? fatal_error{code} : fatal_error{code, std::generic_category(), what};
-    case EMSGSIZE:     /* Message too long */
-      throw !what ? logic_error{code} : logic_error{code, std::generic_category(), what};
-    case ENAMETOOLONG: /* File name too long */
-      throw !what ? logic_error{code} : logic_error{code, std::generic_category(), what};
     case ENFILE:       /* Too many open files in system */
-      throw !what ? fatal_error{code} : fatal_error{code, std::generic_category(), what};
     case ENOBUFS:      /* No buffer space available in kernel */
-      throw !what ? fatal_error{code} : fatal_error{code, std::generic_category(), what};
     case ENOMEM:       /* Cannot allocate memory in kernel */
-      throw !what ? fatal_error{code} : fatal_error{code, std::generic_category(), what};
     case ENOSPC:       /* No space left on device */
-      throw !what ? fatal_error{code} : fatal_error{code, std::generic_category(), what};
+      throw error::attach(fatal_error{code}, std::move(context));
+    case EMSGSIZE:     /* Message too long */
+    case ENAMETOOLONG: /* File name too long */
     case ENOSYS:       /* Function not implemented */
-      throw !what ? logic_error{code} : logic_error{code, std::generic_category(), what};
     case ENOTDIR:      /* Not a directory */
-      throw !what ? logic_error{code} : logic_error{code, std::generic_category(), what};
+      throw error::attach(logic_error{code}, std::move(context));
     case EACCES:       /* Permission denied */
     case ELOOP:        /* Too many levels of symbolic links */
     case ENOENT:       /* No such file or directory */
@@ -136,6 +360,6 @@ posix::throw_error(const int code,
     case ENOTCONN:     /* Transport endpoint is not connected */
     case ENOTSOCK:     /* Socket operation on non-socket */
     default:
-      throw !what ? runtime_error{code} : runtime_error{code, std::generic_category(), what};
+      throw error::attach(runtime_error{code}, std::move(context));
   }
 }
@@ -10,7 +10,9 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 #include <cstdarg>      /* for va_list */
+#include <memory>       /* for std::shared_ptr */
 #include <system_error> /* for std::error_*, std::system_* */
+#include <utility>      /* for std::move() */
 
 namespace posix {
   class error;
@@ -36,6 +38,11 @@ namespace posix {
 /**
  * Represents a POSIX runtime error.
  *
+ * Errors raised by `throw_error()` capture their origin and arguments
+ * without formatting them; the "origin(arguments): message" string is
+ * only built upon the first call to `what()`. The origin and format must
+ * therefore be string literals, while `%s` arguments are copied.
+ *
  * @see http://pubs.opengroup.org/onlinepubs/9699919799/basedefs/errno.h.html
  */
 class posix::error : public std::system_error {
@@ -87,6 +94,24 @@ public:
   int number() const noexcept {
     return code().value();
   }
+
+  /**
+   * Returns the explanatory string, formatting it if necessary.
+   */
+  const char* what() const noexcept override;
+
+protected:
+  struct context;
+
+  std::shared_ptr<const context> _context; /* the deferred origin and arguments, if any */
+
+  template <typename E>
+  static E attach(E error, std::shared_ptr<const context> context) noexcept {
+    error._context = std::move(context);
+    return error;
+  }
+
+  friend void throw_error(int code, const char* origin, const char* format, va_list args);
 };
 
 ////////////////////////////////////////////////////////////////////////////////
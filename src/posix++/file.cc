@@ -9,13 +9,17 @@
 #include "directory.h"
 #include "error.h"
 #include "pathname.h"
+#include "splice.h"
 
+#include <algorithm>   /* for std::min() */
 #include <cassert>     /* for assert() */
 #include <cerrno>      /* for errno */
+#include <cstdint>     /* for std::uint8_t */
 #include <fcntl.h>     /* for AT_FDCWD, O_CLOEXEC, posix_fallocate() */
 #include <sys/stat.h>  /* for fstat() */
 #include <sys/types.h> /* for struct stat */
-#include <unistd.h>    /* for ftruncate(), lseek() */
+#include <unistd.h>    /* for copy_file_range(), ftruncate(), lseek(), pread() */
+#include <vector>      /* for std::vector */
 
 using namespace posix;
 
@@ -55,6 +59,43 @@ file::open(const directory& directory,
   return file{directory.fd(), pathname.c_str(), flags, mode};
 }
 
+result<file>
+file::try_open(const pathname& pathname,
+               const int flags,
+               const mode mode) noexcept {
+
+  return try_open(AT_FDCWD, pathname.c_str(), flags, mode);
+}
+
+result<file>
+file::try_open(const directory& directory,
+               const pathname& pathname,
+               const int flags,
+               const mode mode) noexcept {
+
+  return try_open(directory.fd(), pathname.c_str(), flags, mode);
+}
+
+result<file>
+file::try_open(const int dirfd,
+               const char* const pathname,
+               int flags,
+               const mode mode) noexcept {
+
+  assert(dirfd > 0 || dirfd == AT_FDCWD);
+  assert(pathname != nullptr);
+
+#ifdef O_CLOEXEC
+  flags |= O_CLOEXEC; /* POSIX.1-2008 (Linux, FreeBSD) */
+#endif
+
+  const int fd = openat(dirfd, pathname, flags, mode);
+  if (fd == -1) {
+    return result<file>::from_errno();
+  }
+  return result<file>{file{fd}};
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 
 file::file(const int dirfd,
@@ -105,6 +146,82 @@ file::seek(const off_t offset,
   return static_cast<std::size_t>(result);
 }
 
+std::size_t
+file::copy_to(file& target,
+              off_t offset,
+              const std::size_t length) const {
+  std::size_t byte_count = 0;
+
+#ifdef HAVE_COPY_FILE_RANGE
+  /* The maximum number of bytes per copy_file_range() call: */
+  static const std::size_t chunk_size_max = 1UL << 30;
+
+  if (target.status() & O_APPEND) {
+    goto fallback; /* copy_file_range() fails with EBADF */
+  }
+
+  while (byte_count < length) {
+    const std::size_t chunk_size = std::min(length - byte_count, chunk_size_max);
+    const ssize_t rc = ::copy_file_range(fd(), &offset, target.fd(), nullptr, chunk_size, 0);
+    switch (rc) {
+      case -1:
+        switch (errno) {
+          case EINTR:      /* Interrupted system call */
+            continue; /* try again */
+          case EINVAL:     /* Invalid argument */
+          case ENOSYS:     /* Function not implemented */
+          case EOPNOTSUPP: /* Operation not supported */
+          case EXDEV:      /* Invalid cross-device link */
+            goto fallback;
+          default:
+            throw_error("copy_file_range", "%d, 0x%lx, %d, %s, %zu, 0x%x",
+              fd(), static_cast<unsigned long>(offset), target.fd(), "NULL", chunk_size, 0U);
+        }
+
+      case 0:
+        return byte_count; /* EOF */
+
+      default:
+        assert(rc > 0);
+        byte_count += static_cast<std::size_t>(rc);
+    }
+  }
+  return byte_count;
+
+fallback:
+#endif /* HAVE_COPY_FILE_RANGE */
+
+  if (splice_through_pipe(*this, &offset, target, length - byte_count, byte_count)) {
+    return byte_count;
+  }
+
+  std::vector<std::uint8_t> buffer(65536);
+  while (byte_count < length) {
+    const std::size_t chunk_size = std::min(length - byte_count, buffer.size());
+    const ssize_t rc = ::pread(fd(), buffer.data(), chunk_size, offset);
+    switch (rc) {
+      case -1:
+        switch (errno) {
+          case EINTR: /* Interrupted system call */
+            continue; /* try again */
+          default:
+            throw_error("pread", "%d, %s, %zu, 0x%lx", fd(), "buffer",
+              chunk_size, static_cast<unsigned long>(offset));
+        }
+
+      case 0:
+        return byte_count; /* EOF */
+
+      default:
+        assert(rc > 0);
+        target.write(buffer.data(), static_cast<std::size_t>(rc));
+        offset += rc;
+        byte_count += static_cast<std::size_t>(rc);
+    }
+  }
+  return byte_count;
+}
+
 void
 file::allocate(const off_t offset,
                const off_t length) const {
@@ -11,6 +11,7 @@
 
 #include "descriptor.h"
 #include "mode.h"
+#include "result.h"
 
 #include <cstddef>  /* for std::size_t */
 #include <unistd.h> /* for SEEK_*, off_t */
@@ -39,6 +40,20 @@ public:
 
   static file open(const directory& directory, const pathname& pathname, int flags, mode mode = 0);
 
+  /**
+   * Opens a file, without throwing.
+   *
+   * @return the opened file, or the error code on failure
+   */
+  static result<file> try_open(const pathname& pathname, int flags, mode mode = 0) noexcept;
+
+  /**
+   * Opens a file relative to a directory, without throwing.
+   *
+   * @return the opened file, or the error code on failure
+   */
+  static result<file> try_open(const directory& directory, const pathname& pathname, int flags, mode mode = 0) noexcept;
+
   /**
    * Default constructor.
    */
@@ -104,6 +119,23 @@ public:
    */
   std::size_t seek(off_t offset, int whence = SEEK_SET) const;
 
+  /**
+   * Copies data from this file, starting at the given offset, to the
+   * current file offset of the given target file, until EOF or until
+   * `length` bytes have been copied.
+   *
+   * Uses `copy_file_range()`, allowing the kernel to perform server-side
+   * copies or reflinks, and falls back to `splice()` and then to
+   * `pread()`/`write()` where that is not supported. The file offset of
+   * this file is left unchanged.
+   *
+   * @return the number of bytes copied
+   * @throws posix::error on failure
+   * @see http://man7.org/linux/man-pages/man2/copy_file_range.2.html
+   */
+  std::size_t copy_to(file& target, off_t offset = 0,
+    std::size_t length = static_cast<std::size_t>(-1)) const;
+
   /**
    * ...
    */
@@ -113,6 +145,9 @@ public:
    * ...
    */
   void truncate(off_t length = 0) const;
+
+protected:
+  static result<file> try_open(int dirfd, const char* pathname, int flags, mode mode) noexcept;
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,555 @@
+/* This is free and unencumbered software released into the public domain. */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "io_ring.h"
+
+#include "error.h"
+
+#include <algorithm>           /* for std::max() */
+#include <cassert>             /* for assert() */
+#include <cerrno>              /* for errno */
+#include <cstring>             /* for std::memset() */
+#include <sys/socket.h>        /* for SOCK_CLOEXEC */
+#include <sys/uio.h>           /* for struct iovec */
+
+#if defined(__linux__) && defined(HAVE_LINUX_IO_URING_H)
+#include <linux/io_uring.h>    /* for IORING_*, IOSQE_*, struct io_uring_* */
+#include <sched.h>             /* for sched_yield() */
+#include <sys/mman.h>          /* for mmap(), munmap() */
+#include <sys/syscall.h>       /* for __NR_io_uring_*() */
+#include <unistd.h>            /* for syscall() */
+/* Kernel headers predating Linux 5.6 lack most of the opcodes we use: */
+#if defined(__NR_io_uring_setup) && defined(IORING_FEAT_CUR_PERSONALITY)
+#define POSIXXX_IO_URING 1
+#endif
+#endif
+
+using namespace posix;
+
+#ifdef POSIXXX_IO_URING
+namespace {
+  int
+  io_uring_setup(const unsigned int entries,
+                 struct io_uring_params* const params) noexcept {
+    return static_cast<int>(::syscall(__NR_io_uring_setup, entries, params));
+  }
+
+  void*
+  map_ring(const int fd,
+           const std::size_t size,
+           const off_t offset) {
+    void* const addr = ::mmap(nullptr, size, PROT_READ | PROT_WRITE,
+      MAP_SHARED | MAP_POPULATE, fd, offset);
+    if (addr == MAP_FAILED) {
+      throw_error("mmap", "%s, %zu, %s, %s, %d, 0x%llx", "NULL", size,
+        "PROT_READ | PROT_WRITE", "MAP_SHARED | MAP_POPULATE", fd,
+        static_cast<unsigned long long>(offset));
+    }
+    return addr;
+  }
+
+  template<typename T>
+  T*
+  ring_field(void* const ring,
+             const unsigned int offset) noexcept {
+    return reinterpret_cast<T*>(reinterpret_cast<char*>(ring) + offset);
+  }
+}
+#endif /* POSIXXX_IO_URING */
+
+bool
+io_ring::supported() noexcept {
+#ifdef POSIXXX_IO_URING
+  struct io_uring_params params;
+  std::memset(&params, 0, sizeof(params));
+  const int fd = io_uring_setup(1, &params);
+  if (fd == -1) {
+    return false; /* ENOSYS, or EPERM if disabled by the administrator */
+  }
+  ::close(fd);
+  return (params.features & IORING_FEAT_CUR_PERSONALITY) != 0;
+#else
+  return false;
+#endif /* POSIXXX_IO_URING */
+}
+
+io_ring::io_ring(const unsigned int entries,
+                 const unsigned int flags,
+                 const unsigned int sq_thread_idle)
+  : _flags{flags} {
+#ifdef POSIXXX_IO_URING
+  struct io_uring_params params;
+  std::memset(&params, 0, sizeof(params));
+  params.flags = flags;
+  params.sq_thread_idle = sq_thread_idle;
+
+  int fd;
+  if ((fd = io_uring_setup(entries, &params)) == -1) {
+    throw_error("io_uring_setup", "%u, {0x%x, %u}", entries, flags, sq_thread_idle);
+  }
+  _ring.assign(fd);
+
+  if (!(params.features & IORING_FEAT_CUR_PERSONALITY)) {
+    throw_error(ENOSYS); /* Function not implemented; kernel predates 5.6 */
+  }
+
+  _sq_entries = params.sq_entries;
+  _sq_ring_size = params.sq_off.array + params.sq_entries * sizeof(unsigned int);
+  _cq_ring_size = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+  _sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+
+  try {
+    if (params.features & IORING_FEAT_SINGLE_MMAP) {
+      _sq_ring_size = _cq_ring_size = std::max(_sq_ring_size, _cq_ring_size);
+      _sq_ring = _cq_ring = map_ring(fd, _sq_ring_size, IORING_OFF_SQ_RING);
+    }
+    else {
+      _sq_ring = map_ring(fd, _sq_ring_size, IORING_OFF_SQ_RING);
+      _cq_ring = map_ring(fd, _cq_ring_size, IORING_OFF_CQ_RING);
+    }
+    _sqes = map_ring(fd, _sqes_size, IORING_OFF_SQES);
+  }
+  catch (...) {
+    unmap();
+    throw;
+  }
+
+  _sq_head = ring_field<unsigned int>(_sq_ring, params.sq_off.head);
+  _sq_tail = ring_field<unsigned int>(_sq_ring, params.sq_off.tail);
+  _sq_mask = ring_field<unsigned int>(_sq_ring, params.sq_off.ring_mask);
+  _sq_ring_flags = ring_field<unsigned int>(_sq_ring, params.sq_off.flags);
+  _sq_array = ring_field<unsigned int>(_sq_ring, params.sq_off.array);
+  _cq_head = ring_field<unsigned int>(_cq_ring, params.cq_off.head);
+  _cq_tail = ring_field<unsigned int>(_cq_ring, params.cq_off.tail);
+  _cq_mask = ring_field<unsigned int>(_cq_ring, params.cq_off.ring_mask);
+  _cqes = ring_field<void>(_cq_ring, params.cq_off.cqes);
+
+  _sq_local_tail = _sq_submitted = *_sq_tail;
+#else
+  (void)entries, (void)sq_thread_idle;
+  throw_error(ENOSYS); /* Function not implemented */
+#endif /* POSIXXX_IO_URING */
+}
+
+io_ring::~io_ring() noexcept {
+  unmap();
+}
+
+void
+io_ring::unmap() noexcept {
+#ifdef POSIXXX_IO_URING
+  if (_sqes) {
+    ::munmap(_sqes, _sqes_size);
+    _sqes = nullptr;
+  }
+  if (_cq_ring && _cq_ring != _sq_ring) {
+    ::munmap(_cq_ring, _cq_ring_size);
+  }
+  _cq_ring = nullptr;
+  if (_sq_ring) {
+    ::munmap(_sq_ring, _sq_ring_size);
+    _sq_ring = nullptr;
+  }
+#endif /* POSIXXX_IO_URING */
+}
+
+void
+io_ring::register_buffers(const struct iovec* const iov,
+                          const std::size_t iovcnt) {
+  assert(iov != nullptr || iovcnt == 0);
+
+#ifdef POSIXXX_IO_URING
+  register_(IORING_REGISTER_BUFFERS, iov, static_cast<unsigned int>(iovcnt));
+#else
+  (void)iovcnt;
+  throw_error(ENOSYS); /* Function not implemented */
+#endif /* POSIXXX_IO_URING */
+}
+
+void
+io_ring::unregister_buffers() {
+#ifdef POSIXXX_IO_URING
+  register_(IORING_UNREGISTER_BUFFERS, nullptr, 0);
+#else
+  throw_error(ENOSYS); /* Function not implemented */
+#endif /* POSIXXX_IO_URING */
+}
+
+void
+io_ring::register_files(const int* const fds,
+                        const std::size_t count) {
+  assert(fds != nullptr || count == 0);
+
+#ifdef POSIXXX_IO_URING
+  register_(IORING_REGISTER_FILES, fds, static_cast<unsigned int>(count));
+
+  _files.clear();
+  for (std::size_t i = 0; i < count; i++) {
+    if (fds[i] != -1) {
+      _files[fds[i]] = static_cast<unsigned int>(i);
+    }
+  }
+#else
+  (void)count;
+  throw_error(ENOSYS); /* Function not implemented */
+#endif /* POSIXXX_IO_URING */
+}
+
+void
+io_ring::unregister_files() {
+#ifdef POSIXXX_IO_URING
+  register_(IORING_UNREGISTER_FILES, nullptr, 0);
+  _files.clear();
+#else
+  throw_error(ENOSYS); /* Function not implemented */
+#endif /* POSIXXX_IO_URING */
+}
+
+void
+io_ring::register_(const unsigned int opcode,
+                   const void* const arg,
+                   const unsigned int count) {
+#ifdef POSIXXX_IO_URING
+retry:
+  if (::syscall(__NR_io_uring_register, _ring.fd(), opcode, arg, count) == -1) {
+    switch (errno) {
+      case EINTR: /* Interrupted system call */
+        goto retry;
+      default:
+        throw_error("io_uring_register", "%d, %u, %p, %u", _ring.fd(), opcode, arg, count);
+    }
+  }
+#else
+  (void)opcode, (void)arg, (void)count;
+  throw_error(ENOSYS); /* Function not implemented */
+#endif /* POSIXXX_IO_URING */
+}
+
+void
+io_ring::read(const descriptor& descriptor,
+              void* const buffer,
+              const std::size_t size,
+              const off_t offset,
+              const std::uint64_t user_data) {
+  assert(buffer != nullptr || size == 0);
+
+#ifdef POSIXXX_IO_URING
+  prepare(IORING_OP_READ, descriptor.fd(), buffer, size, offset, 0, 0, user_data);
+#else
+  (void)descriptor, (void)size, (void)offset, (void)user_data;
+  throw_error(ENOSYS); /* Function not implemented */
+#endif /* POSIXXX_IO_URING */
+}
+
+void
+io_ring::read_fixed(const descriptor& descriptor,
+                    void* const buffer,
+                    const std::size_t size,
+                    const off_t offset,
+                    const unsigned int buffer_index,
+                    const std::uint64_t user_data) {
+  assert(buffer != nullptr || size == 0);
+
+#ifdef POSIXXX_IO_URING
+  prepare(IORING_OP_READ_FIXED, descriptor.fd(), buffer, size, offset, 0,
+    static_cast<std::uint16_t>(buffer_index), user_data);
+#else
+  (void)descriptor, (void)size, (void)offset, (void)buffer_index, (void)user_data;
+  throw_error(ENOSYS); /* Function not implemented */
+#endif /* POSIXXX_IO_URING */
+}
+
+void
+io_ring::readv(const descriptor& descriptor,
+               const struct iovec* const iov,
+               const std::size_t iovcnt,
+               const off_t offset,
+               const std::uint64_t user_data) {
+  assert(iov != nullptr || iovcnt == 0);
+
+#ifdef POSIXXX_IO_URING
+  prepare(IORING_OP_READV, descriptor.fd(), iov, iovcnt, offset, 0, 0, user_data);
+#else
+  (void)descriptor, (void)iovcnt, (void)offset, (void)user_data;
+  throw_error(ENOSYS); /* Function not implemented */
+#endif /* POSIXXX_IO_URING */
+}
+
+void
+io_ring::write(const descriptor& descriptor,
+               const void* const data,
+               const std::size_t size,
+               const off_t offset,
+               const std::uint64_t user_data) {
+  assert(data != nullptr || size == 0);
+
+#ifdef POSIXXX_IO_URING
+  prepare(IORING_OP_WRITE, descriptor.fd(), data, size, offset, 0, 0, user_data);
+#else
+  (void)descriptor, (void)size, (void)offset, (void)user_data;
+  throw_error(ENOSYS); /* Function not implemented */
+#endif /* POSIXXX_IO_URING */
+}
+
+void
+io_ring::write_fixed(const descriptor& descriptor,
+                     const void* const data,
+                     const std::size_t size,
+                     const off_t offset,
+                     const unsigned int buffer_index,
+                     const std::uint64_t user_data) {
+  assert(data != nullptr || size == 0);
+
+#ifdef POSIXXX_IO_URING
+  prepare(IORING_OP_WRITE_FIXED, descriptor.fd(), data, size, offset, 0,
+    static_cast<std::uint16_t>(buffer_index), user_data);
+#else
+  (void)descriptor, (void)size, (void)offset, (void)buffer_index, (void)user_data;
+  throw_error(ENOSYS); /* Function not implemented */
+#endif /* POSIXXX_IO_URING */
+}
+
+void
+io_ring::writev(const descriptor& descriptor,
+                const struct iovec* const iov,
+                const std::size_t iovcnt,
+                const off_t offset,
+                const std::uint64_t user_data) {
+  assert(iov != nullptr || iovcnt == 0);
+
+#ifdef POSIXXX_IO_URING
+  prepare(IORING_OP_WRITEV, descriptor.fd(), iov, iovcnt, offset, 0, 0, user_data);
+#else
+  (void)descriptor, (void)iovcnt, (void)offset, (void)user_data;
+  throw_error(ENOSYS); /* Function not implemented */
+#endif /* POSIXXX_IO_URING */
+}
+
+void
+io_ring::fsync(const descriptor& descriptor,
+               const unsigned int flags,
+               const std::uint64_t user_data) {
+#ifdef POSIXXX_IO_URING
+  prepare(IORING_OP_FSYNC, descriptor.fd(), nullptr, 0, 0, flags, 0, user_data);
+#else
+  (void)descriptor, (void)flags, (void)user_data;
+  throw_error(ENOSYS); /* Function not implemented */
+#endif /* POSIXXX_IO_URING */
+}
+
+void
+io_ring::send(const descriptor& socket,
+              const void* const data,
+              const std::size_t size,
+              const int flags,
+              const std::uint64_t user_data) {
+  assert(data != nullptr || size == 0);
+
+#ifdef POSIXXX_IO_URING
+  prepare(IORING_OP_SEND, socket.fd(), data, size, 0,
+    static_cast<std::uint32_t>(flags), 0, user_data);
+#else
+  (void)socket, (void)size, (void)flags, (void)user_data;
+  throw_error(ENOSYS); /* Function not implemented */
+#endif /* POSIXXX_IO_URING */
+}
+
+void
+io_ring::recv(const descriptor& socket,
+              void* const buffer,
+              const std::size_t size,
+              const int flags,
+              const std::uint64_t user_data) {
+  assert(buffer != nullptr || size == 0);
+
+#ifdef POSIXXX_IO_URING
+  prepare(IORING_OP_RECV, socket.fd(), buffer, size, 0,
+    static_cast<std::uint32_t>(flags), 0, user_data);
+#else
+  (void)socket, (void)size, (void)flags, (void)user_data;
+  throw_error(ENOSYS); /* Function not implemented */
+#endif /* POSIXXX_IO_URING */
+}
+
+void
+io_ring::accept(const descriptor& socket,
+                const std::uint64_t user_data) {
+#ifdef POSIXXX_IO_URING
+  prepare(IORING_OP_ACCEPT, socket.fd(), nullptr, 0, 0, SOCK_CLOEXEC, 0, user_data);
+#else
+  (void)socket, (void)user_data;
+  throw_error(ENOSYS); /* Function not implemented */
+#endif /* POSIXXX_IO_URING */
+}
+
+void
+io_ring::close(descriptor& descriptor,
+               const std::uint64_t user_data) {
+#ifdef POSIXXX_IO_URING
+  /* Closing doesn't support registered descriptors, and the descriptor
+   * number may be reused as soon as the operation completes. Moreover,
+   * the fixed-file table holds its own reference to the file, so its slot
+   * must be cleared for the file to actually be closed: */
+  const auto found = _files.find(descriptor.fd());
+  if (found != _files.end()) {
+    const std::int32_t none = -1;
+    struct io_uring_files_update update;
+    std::memset(&update, 0, sizeof(update));
+    update.offset = found->second;
+    update.fds = reinterpret_cast<std::uintptr_t>(&none);
+    register_(IORING_REGISTER_FILES_UPDATE, &update, 1);
+    _files.erase(found);
+  }
+  prepare(IORING_OP_CLOSE, descriptor.fd(), nullptr, 0, 0, 0, 0, user_data);
+  descriptor.release();
+#else
+  (void)descriptor, (void)user_data;
+  throw_error(ENOSYS); /* Function not implemented */
+#endif /* POSIXXX_IO_URING */
+}
+
+void
+io_ring::prepare(const std::uint8_t opcode,
+                 const int fd,
+                 const void* const addr,
+                 const std::size_t len,
+                 const off_t offset,
+                 const std::uint32_t op_flags,
+                 const std::uint16_t buf_index,
+                 const std::uint64_t user_data) {
+#ifdef POSIXXX_IO_URING
+  /* Make room in the submission queue, if necessary: */
+  while (_sq_local_tail - __atomic_load_n(_sq_head, __ATOMIC_ACQUIRE) >= _sq_entries) {
+    if (!submit() && (_flags & IORING_SETUP_SQPOLL)) {
+      ::sched_yield(); /* wait for the kernel thread to catch up */
+    }
+  }
+
+  const unsigned int index = _sq_local_tail & *_sq_mask;
+  struct io_uring_sqe* const sqe =
+    reinterpret_cast<struct io_uring_sqe*>(_sqes) + index;
+  std::memset(sqe, 0, sizeof(*sqe));
+  sqe->opcode = opcode;
+  sqe->fd = fd;
+  sqe->off = static_cast<std::uint64_t>(offset);
+  sqe->addr = reinterpret_cast<std::uintptr_t>(addr);
+  sqe->len = static_cast<std::uint32_t>(len);
+  sqe->rw_flags = static_cast<decltype(sqe->rw_flags)>(op_flags);
+  sqe->buf_index = buf_index;
+  sqe->user_data = user_data;
+
+  if (!_files.empty()) {
+    const auto found = _files.find(fd);
+    if (found != _files.end()) {
+      sqe->fd = static_cast<std::int32_t>(found->second);
+      sqe->flags |= IOSQE_FIXED_FILE;
+    }
+  }
+
+  _sq_array[index] = index;
+  _sq_local_tail++;
+#else
+  (void)opcode, (void)fd, (void)addr, (void)len, (void)offset;
+  (void)op_flags, (void)buf_index, (void)user_data;
+  throw_error(ENOSYS); /* Function not implemented */
+#endif /* POSIXXX_IO_URING */
+}
+
+unsigned int
+io_ring::submit() {
+  return submit_and_wait(0);
+}
+
+unsigned int
+io_ring::submit_and_wait(const unsigned int wait_nr) {
+#ifdef POSIXXX_IO_URING
+  const unsigned int to_submit = _sq_local_tail - _sq_submitted;
+  if (to_submit) {
+    __atomic_store_n(_sq_tail, _sq_local_tail, __ATOMIC_RELEASE);
+  }
+
+  unsigned int enter_flags = wait_nr ? IORING_ENTER_GETEVENTS : 0;
+
+  if (_flags & IORING_SETUP_SQPOLL) {
+    /* The kernel thread picks up new entries by itself, unless idle: */
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    if (__atomic_load_n(_sq_ring_flags, __ATOMIC_RELAXED) & IORING_SQ_NEED_WAKEUP) {
+      enter_flags |= IORING_ENTER_SQ_WAKEUP;
+    }
+    _sq_submitted = _sq_local_tail;
+    if (enter_flags) {
+      enter(to_submit, wait_nr, enter_flags);
+    }
+    return to_submit;
+  }
+
+  if (!to_submit && !wait_nr) {
+    return 0;
+  }
+
+  const unsigned int submitted = enter(to_submit, wait_nr, enter_flags);
+  _sq_submitted += submitted;
+  return submitted;
+#else
+  (void)wait_nr;
+  throw_error(ENOSYS); /* Function not implemented */
+#endif /* POSIXXX_IO_URING */
+}
+
+unsigned int
+io_ring::enter(const unsigned int to_submit,
+               const unsigned int min_complete,
+               const unsigned int flags) {
+#ifdef POSIXXX_IO_URING
+retry:
+  const long rc = ::syscall(__NR_io_uring_enter, _ring.fd(),
+    to_submit, min_complete, flags, nullptr, 0);
+  if (rc == -1) {
+    switch (errno) {
+      case EINTR: /* Interrupted system call */
+        goto retry;
+      default:
+        throw_error("io_uring_enter", "%d, %u, %u, 0x%x, %s, %d",
+          _ring.fd(), to_submit, min_complete, flags, "NULL", 0);
+    }
+  }
+  return static_cast<unsigned int>(rc);
+#else
+  (void)to_submit, (void)min_complete, (void)flags;
+  throw_error(ENOSYS); /* Function not implemented */
+#endif /* POSIXXX_IO_URING */
+}
+
+bool
+io_ring::pop(io_completion& completion) noexcept {
+#ifdef POSIXXX_IO_URING
+  const unsigned int head = *_cq_head;
+  if (head == __atomic_load_n(_cq_tail, __ATOMIC_ACQUIRE)) {
+    return false;
+  }
+
+  const struct io_uring_cqe& cqe =
+    reinterpret_cast<const struct io_uring_cqe*>(_cqes)[head & *_cq_mask];
+  completion.user_data = cqe.user_data;
+  completion.result = cqe.res;
+  completion.flags = cqe.flags;
+
+  __atomic_store_n(_cq_head, head + 1, __ATOMIC_RELEASE);
+  return true;
+#else
+  (void)completion;
+  return false;
+#endif /* POSIXXX_IO_URING */
+}
+
+io_completion
+io_ring::wait() {
+  io_completion completion;
+  while (!pop(completion)) {
+    submit_and_wait(1);
+  }
+  return completion;
+}
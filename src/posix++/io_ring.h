@@ -0,0 +1,301 @@
+/* This is free and unencumbered software released into the public domain. */
+
+#ifndef POSIXXX_IO_RING_H
+#define POSIXXX_IO_RING_H
+
+#ifndef __cplusplus
+#error "<posix++/io_ring.h> requires a C++ compiler"
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include "descriptor.h"
+
+#include <cstddef>       /* for std::size_t */
+#include <cstdint>       /* for std::int32_t, std::uint32_t, std::uint64_t */
+#include <sys/types.h>   /* for off_t */
+#include <unordered_map> /* for std::unordered_map */
+
+struct iovec; // @see <sys/uio.h>
+
+namespace posix {
+  struct io_completion;
+  class io_ring;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Represents the completion of an asynchronous I/O operation.
+ */
+struct posix::io_completion {
+  /**
+   * The user data given when the operation was queued.
+   */
+  std::uint64_t user_data;
+
+  /**
+   * The result of the operation, as returned by the corresponding system
+   * call, or a negated `errno` value on failure.
+   */
+  std::int32_t result;
+
+  /**
+   * The `IORING_CQE_F_*` completion flags.
+   */
+  std::uint32_t flags;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * An asynchronous I/O submission and completion ring (aka `io_uring`).
+ *
+ * Operations are queued with the methods named after their synchronous
+ * counterparts, submitted to the kernel in batches with `submit()`, and
+ * their results retrieved with `pop()` or `wait()`.
+ *
+ * Once descriptors have been registered with `register_files()`,
+ * operations on them transparently refer to their registered index,
+ * which spares the kernel a file table lookup per operation.
+ *
+ * Buffers and descriptors given to queued operations must remain valid
+ * until the corresponding completion has been retrieved.
+ *
+ * @note This class is Linux-specific. Where `io_uring` is unavailable,
+ *       the constructor throws a `posix::logic_error` with `ENOSYS`.
+ * @note Instances of this class are neither copyable nor movable.
+ * @see http://man7.org/linux/man-pages/man7/io_uring.7.html
+ */
+class posix::io_ring {
+public:
+  /**
+   * Checks whether the running kernel supports `io_uring`.
+   */
+  static bool supported() noexcept;
+
+  /**
+   * Constructor.
+   *
+   * @param entries the submission queue size, rounded up to a power of two
+   * @param flags the `IORING_SETUP_*` flags, e.g. `IORING_SETUP_SQPOLL`
+   * @param sq_thread_idle the idle time in milliseconds after which the
+   *                       kernel submission thread goes to sleep, when
+   *                       using `IORING_SETUP_SQPOLL`
+   * @throws posix::error on failure
+   */
+  explicit io_ring(unsigned int entries = 64,
+                   unsigned int flags = 0,
+                   unsigned int sq_thread_idle = 0);
+
+  /**
+   * Copy constructor.
+   */
+  io_ring(const io_ring& other) = delete;
+
+  /**
+   * Copy assignment operator.
+   */
+  io_ring& operator=(const io_ring& other) = delete;
+
+  /**
+   * Destructor.
+   */
+  ~io_ring() noexcept;
+
+  /**
+   * Returns the underlying ring descriptor.
+   */
+  const descriptor& ring() const noexcept {
+    return _ring;
+  }
+
+  /**
+   * Returns the submission queue size.
+   */
+  unsigned int capacity() const noexcept {
+    return _sq_entries;
+  }
+
+  /**
+   * Returns the number of queued operations not yet submitted.
+   */
+  unsigned int pending() const noexcept {
+    return _sq_local_tail - _sq_submitted;
+  }
+
+  /**
+   * Registers fixed buffers for use with `read_fixed()`/`write_fixed()`.
+   *
+   * @throws posix::error on failure
+   */
+  void register_buffers(const struct iovec* iov, std::size_t iovcnt);
+
+  /**
+   * Unregisters all fixed buffers.
+   *
+   * @throws posix::error on failure
+   */
+  void unregister_buffers();
+
+  /**
+   * Registers fixed descriptors. Subsequently queued operations on these
+   * descriptors will refer to them by their registered index.
+   *
+   * @throws posix::error on failure
+   */
+  void register_files(const int* fds, std::size_t count);
+
+  /**
+   * Unregisters all fixed descriptors.
+   *
+   * @throws posix::error on failure
+   */
+  void unregister_files();
+
+  /**
+   * Queues a read into a single buffer.
+   *
+   * @param offset the file offset, or -1 for the current file offset
+   */
+  void read(const descriptor& descriptor, void* buffer, std::size_t size,
+    off_t offset, std::uint64_t user_data);
+
+  /**
+   * Queues a read into a registered buffer.
+   */
+  void read_fixed(const descriptor& descriptor, void* buffer, std::size_t size,
+    off_t offset, unsigned int buffer_index, std::uint64_t user_data);
+
+  /**
+   * Queues a read into multiple buffers.
+   */
+  void readv(const descriptor& descriptor, const struct iovec* iov,
+    std::size_t iovcnt, off_t offset, std::uint64_t user_data);
+
+  /**
+   * Queues a write from a single buffer.
+   *
+   * @param offset the file offset, or -1 for the current file offset
+   */
+  void write(const descriptor& descriptor, const void* data, std::size_t size,
+    off_t offset, std::uint64_t user_data);
+
+  /**
+   * Queues a write from a registered buffer.
+   */
+  void write_fixed(const descriptor& descriptor, const void* data, std::size_t size,
+    off_t offset, unsigned int buffer_index, std::uint64_t user_data);
+
+  /**
+   * Queues a write from multiple buffers.
+   */
+  void writev(const descriptor& descriptor, const struct iovec* iov,
+    std::size_t iovcnt, off_t offset, std::uint64_t user_data);
+
+  /**
+   * Queues a file synchronization.
+   *
+   * @param flags zero, or `IORING_FSYNC_DATASYNC`
+   */
+  void fsync(const descriptor& descriptor, unsigned int flags,
+    std::uint64_t user_data);
+
+  /**
+   * Queues a send on a socket.
+   */
+  void send(const descriptor& socket, const void* data, std::size_t size,
+    int flags, std::uint64_t user_data);
+
+  /**
+   * Queues a receive on a socket.
+   */
+  void recv(const descriptor& socket, void* buffer, std::size_t size,
+    int flags, std::uint64_t user_data);
+
+  /**
+   * Queues an accept on a listening socket. The completion result is the
+   * accepted native integer descriptor, which has `O_CLOEXEC` set.
+   */
+  void accept(const descriptor& socket, std::uint64_t user_data);
+
+  /**
+   * Queues closing a descriptor, taking over its ownership.
+   *
+   * @post `descriptor` is in an invalid state.
+   */
+  void close(descriptor& descriptor, std::uint64_t user_data);
+
+  /**
+   * Submits all queued operations to the kernel.
+   *
+   * @return the number of operations submitted
+   * @throws posix::error on failure
+   */
+  unsigned int submit();
+
+  /**
+   * Submits all queued operations, and waits until at least the given
+   * number of completions are available.
+   *
+   * @return the number of operations submitted
+   * @throws posix::error on failure
+   */
+  unsigned int submit_and_wait(unsigned int wait_nr);
+
+  /**
+   * Retrieves a completion, if one is available, without blocking.
+   *
+   * @return `true` if a completion was retrieved
+   */
+  bool pop(io_completion& completion) noexcept;
+
+  /**
+   * Submits all queued operations, and retrieves a completion, blocking
+   * until one is available.
+   *
+   * @throws posix::error on failure
+   */
+  io_completion wait();
+
+protected:
+  void prepare(std::uint8_t opcode, int fd, const void* addr, std::size_t len,
+    off_t offset, std::uint32_t op_flags, std::uint16_t buf_index,
+    std::uint64_t user_data);
+
+  unsigned int enter(unsigned int to_submit, unsigned int min_complete,
+    unsigned int flags);
+
+  void register_(unsigned int opcode, const void* arg, unsigned int count);
+
+  void unmap() noexcept;
+
+  descriptor _ring;
+  unsigned int _flags = 0;
+  unsigned int _sq_entries = 0;
+  unsigned int _sq_local_tail = 0;
+  unsigned int _sq_submitted = 0;
+
+  void* _sq_ring = nullptr;
+  std::size_t _sq_ring_size = 0;
+  void* _cq_ring = nullptr;
+  std::size_t _cq_ring_size = 0;
+  void* _sqes = nullptr;
+  std::size_t _sqes_size = 0;
+
+  unsigned int* _sq_head = nullptr;
+  unsigned int* _sq_tail = nullptr;
+  unsigned int* _sq_mask = nullptr;
+  unsigned int* _sq_ring_flags = nullptr;
+  unsigned int* _sq_array = nullptr;
+  unsigned int* _cq_head = nullptr;
+  unsigned int* _cq_tail = nullptr;
+  unsigned int* _cq_mask = nullptr;
+  void* _cqes = nullptr;
+
+  std::unordered_map<int, unsigned int> _files;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif /* POSIXXX_IO_RING_H */
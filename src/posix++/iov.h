@@ -0,0 +1,31 @@
+/* This is free and unencumbered software released into the public domain. */
+
+#ifndef POSIXXX_IOV_H
+#define POSIXXX_IOV_H
+
+#ifndef __cplusplus
+#error "<posix++/iov.h> requires a C++ compiler"
+#endif
+
+/* This is an internal header, not installed along with the public ones. */
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include <climits> /* for IOV_MAX */
+#include <cstddef> /* for std::size_t */
+
+namespace posix {
+  /**
+   * The maximum number of buffers per scatter/gather system call, such
+   * as `readv()`, `writev()`, `recvmsg()`, and `sendmsg()`.
+   */
+#ifdef IOV_MAX
+  constexpr std::size_t iov_max = IOV_MAX;
+#else
+  constexpr std::size_t iov_max = 1024;
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif /* POSIXXX_IOV_H */
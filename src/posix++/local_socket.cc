@@ -147,6 +147,34 @@ retry:
   return connection;
 }
 
+result<local_socket>
+local_socket::try_accept() noexcept {
+  int connfd;
+retry:
+#if defined(HAVE_ACCEPT4) && defined(SOCK_CLOEXEC)
+  /* Nonstandard Linux extension to set O_CLOEXEC atomically: */
+  if ((connfd = ::accept4(fd(), nullptr, nullptr, SOCK_CLOEXEC)) == -1) {
+#else
+  if ((connfd = ::accept(fd(), nullptr, nullptr)) == -1) {
+#endif
+    switch (errno) {
+      case EINTR:   /* Interrupted system call */
+        goto retry;
+      default:
+        return result<local_socket>::from_errno();
+    }
+  }
+
+  local_socket connection(connfd);
+#if !(defined(HAVE_ACCEPT4) && defined(SOCK_CLOEXEC))
+  if (::fcntl(connfd, F_SETFD, FD_CLOEXEC) == -1) {
+    return result<local_socket>::from_errno();
+  }
+#endif
+
+  return result<local_socket>{std::move(connection)};
+}
+
 void
 local_socket::send_descriptor(const descriptor& descriptor) {
 #ifdef __linux__
@@ -10,6 +10,7 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 #include "descriptor.h"
+#include "result.h"
 #include "socket.h"
 
 #include <utility> /* for std::move(), std::pair */
@@ -69,6 +70,17 @@ public:
    */
   local_socket accept();
 
+  /**
+   * Accepts a connection on this socket, without throwing.
+   *
+   * Retries the operation automatically in case an `EINTR` (interrupted
+   * system call) error is encountered.
+   *
+   * @return the connected socket, or the error code on failure (e.g.
+   *         `EAGAIN` for a non-blocking socket with no pending connections)
+   */
+  result<local_socket> try_accept() noexcept;
+
   /**
    * Sends a descriptor to the peer.
    */
@@ -0,0 +1,308 @@
+/* This is free and unencumbered software released into the public domain. */
+
+#ifndef POSIXXX_MAPPED_ARRAY_H
+#define POSIXXX_MAPPED_ARRAY_H
+
+#ifndef __cplusplus
+#error "<posix++/mapped_array.h> requires a C++ compiler"
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include "error.h"
+#include "mapped_file.h"
+#include "pathname.h"
+
+#include <cassert>     /* for assert() */
+#include <cerrno>      /* for EINVAL */
+#include <cstddef>     /* for std::size_t */
+#include <cstdint>     /* for std::uintptr_t */
+#include <type_traits> /* for std::is_trivially_copyable */
+#include <utility>     /* for std::move() */
+
+namespace posix {
+  enum class byte_order : int;
+  template <typename T> class array_span;
+  template <typename T> class mapped_array;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * The byte order of the records in a file.
+ */
+enum class posix::byte_order : int {
+  any,    /* not checked */
+  little, /* least significant byte first */
+  big,    /* most significant byte first */
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+  native = big,
+#else
+  native = little,
+#endif
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * A non-owning reference to a contiguous sequence of objects, such as a
+ * slice of a memory-mapped array.
+ *
+ * This is a minimal stand-in for C++20's `std::span`.
+ */
+template <typename T>
+class posix::array_span {
+  T* _data;
+  std::size_t _size;
+
+public:
+  using value_type = typename std::remove_cv<T>::type;
+  using iterator = T*;
+
+  /**
+   * Default constructor.
+   */
+  array_span() noexcept
+    : _data{nullptr}, _size{0} {}
+
+  /**
+   * Constructor.
+   */
+  array_span(T* const data, const std::size_t size) noexcept
+    : _data{data}, _size{size} {}
+
+  T* data() const noexcept {
+    return _data;
+  }
+
+  std::size_t size() const noexcept {
+    return _size;
+  }
+
+  bool empty() const noexcept {
+    return _size == 0;
+  }
+
+  T* begin() const noexcept {
+    return _data;
+  }
+
+  T* end() const noexcept {
+    return _data + _size;
+  }
+
+  T& operator[](const std::size_t index) const noexcept {
+    assert(index < _size);
+    return _data[index];
+  }
+
+  /**
+   * Returns the given slice of this span.
+   *
+   * @pre `position + count <= size()`
+   */
+  array_span subspan(const std::size_t position, const std::size_t count) const noexcept {
+    assert(position + count <= _size);
+    return array_span{_data + position, count};
+  }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * A memory-mapped file viewed as an array of fixed-width records, which
+ * are accessed in place, without any copying.
+ *
+ * The records may follow a fixed-size header. Their iterators are plain
+ * pointers, so that standard algorithms such as `std::lower_bound()`,
+ * and `std::sort()` on files opened with `O_RDWR`, work on the file
+ * directly, and `subspan()` partitions it for parallel processing.
+ *
+ * @note Growing the array may move the mapping, which invalidates any
+ *       pointers, references, iterators, and spans into it.
+ */
+template <typename T>
+class posix::mapped_array {
+  static_assert(std::is_trivially_copyable<T>::value,
+    "posix::mapped_array requires a trivially copyable type");
+
+protected:
+  mapped_file _file;
+  std::size_t _offset;
+
+public:
+  using value_type = T;
+  using iterator = T*;
+  using const_iterator = const T*;
+
+  /**
+   * Opens and maps a file as an array.
+   *
+   * @copydetails mapped_array(mapped_file&&, std::size_t, byte_order)
+   */
+  static mapped_array open(const pathname& pathname, const int flags,
+                           const std::size_t offset = 0,
+                           const byte_order order = byte_order::any) {
+    return mapped_array{mapped_file::open(pathname, flags), offset, order};
+  }
+
+  /**
+   * Constructor.
+   *
+   * @param offset the size of the header preceding the records
+   * @param order  the byte order the records were written in, which must
+   *               match the native byte order unless it is `any`
+   * @throws posix::error if the file size is not the header size plus a
+   *         multiple of `sizeof(T)` (`EINVAL`), if the records are not
+   *         suitably aligned for `T` (`EINVAL`), or if the byte order
+   *         does not match (`EILSEQ`)
+   */
+  explicit mapped_array(mapped_file&& file,
+                        const std::size_t offset = 0,
+                        const byte_order order = byte_order::any)
+    : _file{std::move(file)}, _offset{offset} {
+
+    if (_offset > _file.size() || (_file.size() - _offset) % sizeof(T)) {
+      throw_error(EINVAL, "posix::mapped_array", "%zu, %zu, %zu",
+        _file.size(), _offset, sizeof(T));
+    }
+    if (reinterpret_cast<std::uintptr_t>(_file.data(_offset)) % alignof(T)) {
+      throw_error(EINVAL, "posix::mapped_array", "%zu, %zu, %zu",
+        _file.size(), _offset, alignof(T));
+    }
+    if (order != byte_order::any && order != byte_order::native) {
+      throw_error(EILSEQ, "posix::mapped_array", "%zu, %zu, %d",
+        _file.size(), _offset, static_cast<int>(order));
+    }
+  }
+
+  /**
+   * Returns the underlying file.
+   */
+  mapped_file& file() noexcept {
+    return _file;
+  }
+
+  /**
+   * Returns the underlying file.
+   */
+  const mapped_file& file() const noexcept {
+    return _file;
+  }
+
+  /**
+   * Checks whether this array holds no records.
+   */
+  bool empty() const noexcept {
+    return size() == 0;
+  }
+
+  /**
+   * Returns the number of records.
+   */
+  std::size_t size() const noexcept {
+    return (_file.size() - _offset) / sizeof(T);
+  }
+
+  /**
+   * Returns a pointer to the first record.
+   *
+   * @pre The file must be open for reading and writing to modify it.
+   */
+  T* data() noexcept {
+    return _file.template data<T>(_offset);
+  }
+
+  /**
+   * Returns a pointer to the first record.
+   */
+  const T* data() const noexcept {
+    return _file.template data<T>(_offset);
+  }
+
+  T* begin() noexcept {
+    return data();
+  }
+
+  T* end() noexcept {
+    return data() + size();
+  }
+
+  const T* begin() const noexcept {
+    return data();
+  }
+
+  const T* end() const noexcept {
+    return data() + size();
+  }
+
+  const T* cbegin() const noexcept {
+    return begin();
+  }
+
+  const T* cend() const noexcept {
+    return end();
+  }
+
+  T& operator[](const std::size_t index) noexcept {
+    assert(index < size());
+    return data()[index];
+  }
+
+  const T& operator[](const std::size_t index) const noexcept {
+    assert(index < size());
+    return data()[index];
+  }
+
+  /**
+   * Returns the given slice of this array.
+   *
+   * @pre `position + count <= size()`
+   */
+  array_span<T> subspan(const std::size_t position, const std::size_t count) noexcept {
+    assert(position + count <= size());
+    return array_span<T>{data() + position, count};
+  }
+
+  /**
+   * @copydoc subspan(std::size_t, std::size_t)
+   */
+  array_span<const T> subspan(const std::size_t position, const std::size_t count) const noexcept {
+    assert(position + count <= size());
+    return array_span<const T>{data() + position, count};
+  }
+
+  /**
+   * Changes the number of records, growing or truncating the file.
+   * Any added records are zero-filled.
+   *
+   * @throws posix::error with `EBADF` if the file is not open for
+   *         reading and writing, or on any other failure
+   */
+  void resize(const std::size_t count) {
+    _file.resize(_offset + count * sizeof(T));
+  }
+
+  /**
+   * Appends a record, growing the file.
+   *
+   * @throws posix::error with `EBADF` if the file is not open for
+   *         reading and writing, or on any other failure
+   */
+  void push_back(const T record) {
+    _file.write(_file.size(), &record, sizeof(T)); /* may move the mapping */
+  }
+
+  /**
+   * Flushes changes to the records back to secondary storage.
+   *
+   * @throws posix::error on failure
+   */
+  void flush(const int flags = MS_SYNC) {
+    _file.flush(flags);
+  }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif /* POSIXXX_MAPPED_ARRAY_H */
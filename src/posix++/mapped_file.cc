@@ -9,37 +9,44 @@
 #include "mapped_file.h"
 #include "pathname.h"
 
-#include <algorithm>  /* for std::max(), std::min() */
-#include <cassert>    /* for assert() */
-#include <cerrno>     /* for errno */
-#include <cstring>    /* for std::memmove() */
-#include <fcntl.h>    /* for AT_FDCWD */
-#include <unistd.h>   /* for _SC_PAGE_SIZE, sysconf() */
-#include <utility>    /* for std::swap() */
-
-#ifdef __linux__
-#include <sys/mman.h> /* for MREMAP_MAYMOVE */
-#endif
+#include <algorithm>    /* for std::max(), std::min() */
+#include <cassert>      /* for assert() */
+#include <cerrno>       /* for EBADF, EINVAL, EOVERFLOW, errno */
+#include <cstring>      /* for std::memchr(), std::memcpy(), std::memmove(), std::memset() */
+#include <exception>    /* for std::current_exception(), std::rethrow_exception() */
+#include <fcntl.h>      /* for AT_FDCWD, POSIX_FADV_*, posix_fadvise(), readahead() */
+#include <limits>       /* for std::numeric_limits */
+#include <system_error> /* for std::system_error */
+#include <unistd.h>     /* for _SC_PAGE_SIZE, ftruncate(), sysconf() */
+#include <utility>      /* for std::swap() */
+#include <vector>       /* for std::vector */
+
+#include <sys/mman.h>   /* for MADV_*, MAP_*, MREMAP_MAYMOVE, PROT_*, madvise() */
 
 using namespace posix;
 
+constexpr std::size_t mapped_file::default_stream_window;
+constexpr std::size_t appendable_mapped_file::default_append_chunk;
+
 ////////////////////////////////////////////////////////////////////////////////
 
 mapped_file
 mapped_file::open(const pathname& pathname,
                   const int flags,
-                  const mode mode) {
+                  const mode mode,
+                  const int mapping_flags) {
 
-  return mapped_file{AT_FDCWD, pathname.c_str(), flags, mode};
+  return mapped_file{AT_FDCWD, pathname.c_str(), flags, mode, mapping_flags};
 }
 
 mapped_file
 mapped_file::open(const directory& directory,
                   const pathname& pathname,
                   const int flags,
-                  const mode mode) {
+                  const mode mode,
+                  const int mapping_flags) {
 
-  return mapped_file{directory.fd(), pathname.c_str(), flags, mode};
+  return mapped_file{directory.fd(), pathname.c_str(), flags, mode, mapping_flags};
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -48,16 +55,66 @@ namespace {
   static std::size_t system_page_size() {
     return static_cast<std::size_t>(::sysconf(_SC_PAGE_SIZE));
   }
+
+  static int mapping_protection(const int flags) {
+    return (flags & O_ACCMODE) == O_RDWR ? PROT_READ | PROT_WRITE : PROT_READ;
+  }
+
+  static const std::size_t prewarm_chunk_size = 4 * 1024 * 1024;
+
+  static void prewarm_range(const int fd,
+                            std::uint8_t* const data,
+                            const std::size_t offset,
+                            const std::size_t length,
+                            const mapped_file::prewarm_callback& progress) noexcept {
+    const std::size_t page_size = system_page_size();
+    std::size_t done = 0;
+    while (done < length) {
+      const std::size_t chunk_offset = offset + done;
+      const std::size_t chunk_size = std::min(prewarm_chunk_size, length - done);
+
+#ifdef __linux__
+      ::readahead(fd, static_cast<off64_t>(chunk_offset), chunk_size);
+#elif defined(POSIX_FADV_WILLNEED)
+      ::posix_fadvise(fd, static_cast<off_t>(chunk_offset),
+        static_cast<off_t>(chunk_size), POSIX_FADV_WILLNEED);
+#else
+      (void)fd;
+#endif
+
+      if (data) {
+        /* Widen the chunk to page boundaries, as madvise() requires: */
+        std::uint8_t* const start = data + chunk_offset - chunk_offset % page_size;
+        const std::size_t span = chunk_size + chunk_offset % page_size;
+#ifdef MADV_POPULATE_READ
+        if (::madvise(start, span, MADV_POPULATE_READ) == -1)
+#endif
+        ::madvise(start, span, MADV_WILLNEED);
+      }
+
+      done += chunk_size;
+      if (progress) {
+        try {
+          progress(done, length);
+        }
+        catch (...) {
+          return; /* stop prewarming */
+        }
+      }
+    }
+  }
 }
 
 mapped_file::mapped_file(const int dirfd,
                          const char* const pathname,
                          int flags,
-                         const mode mode)
+                         const mode mode,
+                         const int mapping_flags)
   : file{dirfd, pathname, flags, mode},
     _size{file::size()},
     _offset{file::seek(0, SEEK_CUR)},
-    _mapping{*this, std::max(_size, system_page_size())} {
+    _mapping{*this, std::max(_size, system_page_size()), 0,
+      mapping_protection(flags), MAP_SHARED | mapping_flags} {
 
   assert(_mapping.data());
 }
@@ -69,6 +126,15 @@ mapped_file::mapped_file(mapped_file&& other) noexcept
   std::swap(_size, other._size);
   std::swap(_offset, other._offset);
   std::swap(_mapping, other._mapping);
+  std::swap(_window, other._window);
+  std::swap(_trigger, other._trigger);
+  std::swap(_ahead, other._ahead);
+  std::swap(_behind, other._behind);
+  std::swap(_capacity, other._capacity);
+}
+
+mapped_file::~mapped_file() noexcept {
+  close(); /* truncates a preallocated file */
 }
 
 mapped_file&
@@ -78,6 +144,11 @@ mapped_file::operator=(mapped_file&& other) noexcept {
     std::swap(_size, other._size);
     std::swap(_offset, other._offset);
     std::swap(_mapping, other._mapping);
+    std::swap(_window, other._window);
+    std::swap(_trigger, other._trigger);
+    std::swap(_ahead, other._ahead);
+    std::swap(_behind, other._behind);
+    std::swap(_capacity, other._capacity);
   }
   return *this;
 }
@@ -86,8 +157,13 @@ mapped_file::operator=(mapped_file&& other) noexcept {
 
 void
 mapped_file::sync() {
+  if (_capacity) {
+    file::sync(); /* the file extends past its logical end, so keep _size */
+    return;
+  }
+
   if (_mapping.writable()) {
-    file::sync();
+    file::sync(); /* also covers any data written past the mapping */
   }
 
   std::size_t new_size = file::size();
@@ -102,13 +178,231 @@ mapped_file::sync() {
   }
 }
 
+std::thread
+mapped_file::prewarm(const std::size_t offset,
+                     std::size_t length,
+                     const bool background,
+                     prewarm_callback progress) {
+  if (offset >= _size) {
+    length = 0;
+  }
+  else {
+    length = std::min(length, _size - offset);
+  }
+
+  if (!background) {
+    prewarm_range(fd(), _mapping.data(), offset, length, progress);
+    return std::thread{};
+  }
+  /* The thread only reads ahead, through its own descriptor, as the
+   * mapping may be moved or unmapped while it is still running: */
+  return std::thread{[](const descriptor input,
+                        const std::size_t offset,
+                        const std::size_t length,
+                        const prewarm_callback progress) {
+      prewarm_range(input.fd(), nullptr, offset, length, progress);
+    }, dup(), offset, length, std::move(progress)};
+}
+
+void
+mapped_file::resize(const std::size_t new_size) {
+  require_writable("posix::mapped_file::resize", new_size);
+
+  if (_capacity) {
+    /* Preallocated: zero-fill the slack, as ftruncate() would have done. */
+    const std::size_t fill_size = std::min(new_size, _capacity);
+    if (fill_size > _size) {
+      std::memset(_mapping.data(_size), 0, fill_size - _size);
+    }
+    if (new_size <= _capacity) {
+      _size = new_size; /* merely move the logical end */
+      return;
+    }
+    _capacity = new_size;
+  }
+
+  truncate(static_cast<off_t>(new_size));
+  _size = new_size;
+  remap(new_size);
+}
+
+void
+mapped_file::extend(const std::size_t offset,
+                    const std::size_t size) {
+  if (offset > static_cast<std::size_t>(-1) - size) {
+    throw_error(EOVERFLOW, "posix::mapped_file::extend", "%zu, %zu", offset, size);
+  }
+  resize(offset + size);
+}
+
+void
+mapped_file::remap(const std::size_t min_size) {
+  if (min_size <= _mapping.size()) {
+    return; /* nothing to do */
+  }
+
+  /* Grow the mapping geometrically, to amortize the remapping: */
+  const std::size_t page_size = system_page_size();
+  const std::size_t mapping_size = std::max(min_size, 2 * _mapping.size());
+#ifdef __linux__
+  _mapping.remap((mapping_size + page_size - 1) / page_size * page_size, MREMAP_MAYMOVE);
+#else
+  _mapping = memory_mapping{*this, (mapping_size + page_size - 1) / page_size * page_size, 0,
+    _mapping.protection(), _mapping.flags()};
+#endif
+}
+
+void
+mapped_file::require_writable(const char* const origin,
+                              const std::size_t offset) const {
+  if (!_mapping.writable()) {
+    throw_error(EBADF, origin, "%zu", offset); /* not open for writing */
+  }
+}
+
+void
+mapped_file::write(const std::size_t offset,
+                   const void* const data,
+                   const std::size_t size) {
+  assert(data != nullptr || size == 0);
+
+  require_writable("posix::mapped_file::write", offset);
+  cover(offset, size);
+  std::memcpy(_mapping.data(offset), data, size);
+}
+
+void
+mapped_file::parallel_for_each_record(const char separator,
+                                      unsigned int nthreads,
+                                      const record_callback& callback) const {
+  if (!nthreads) {
+    nthreads = std::max(std::thread::hardware_concurrency(), 1U);
+  }
+  const char* const data = _mapping.data<char>();
+
+  /* Snap each chunk boundary to just past the next separator: */
+  std::vector<std::size_t> bounds{0};
+  for (unsigned int i = 1; i < nthreads && bounds.back() < _size; i++) {
+    const std::size_t target = std::max(_size / nthreads * i, bounds.back() + 1);
+    const auto found = static_cast<const char*>(
+      std::memchr(data + target - 1, separator, _size - (target - 1)));
+    bounds.push_back(found ? static_cast<std::size_t>(found - data) + 1 : _size);
+  }
+  if (bounds.back() < _size) {
+    bounds.push_back(_size);
+  }
+
+  const std::size_t chunks = bounds.size() - 1;
+  std::vector<std::exception_ptr> errors(chunks);
+  const auto process = [&](const std::size_t chunk) {
+    try {
+      for (const auto record : string_split{data + bounds[chunk],
+             bounds[chunk + 1] - bounds[chunk], separator}) {
+        callback(record);
+      }
+    }
+    catch (...) {
+      errors[chunk] = std::current_exception();
+    }
+  };
+
+  std::vector<std::thread> threads;
+  threads.reserve(chunks); /* so that emplace_back() only throws std::system_error */
+  std::size_t spawned = 1;
+  try {
+    for (; spawned < chunks; spawned++) {
+      threads.emplace_back(process, spawned);
+    }
+  }
+  catch (const std::system_error&) {
+    /* Out of threads: process the remaining chunks ourselves. */
+  }
+  if (chunks) {
+    process(0);
+  }
+  for (std::size_t chunk = spawned; chunk < chunks; chunk++) {
+    process(chunk);
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  for (const auto& error : errors) {
+    if (error) {
+      std::rethrow_exception(error);
+    }
+  }
+}
+
+void
+mapped_file::close() noexcept {
+  if (_capacity && valid()) {
+    if (::ftruncate(fd(), static_cast<off_t>(_size)) == -1) {
+      /* Ignore any errors from ftruncate() here, as close() does. */
+    }
+  }
+  _capacity = 0;
+  descriptor::close();
+}
+
+void
+mapped_file::stream(const std::size_t window) {
+  const std::size_t page_size = system_page_size();
+  _window = (window + page_size - 1) / page_size * page_size;
+  _mapping.advise(_window ? MADV_SEQUENTIAL : MADV_NORMAL);
+  if (_window) {
+    _ahead = _behind = _offset - _offset % page_size;
+    slide_window();
+  }
+}
+
+void
+mapped_file::slide_window() noexcept {
+  const std::size_t page_size = system_page_size();
+
+  try {
+    /* Read ahead up to one window past the current offset: */
+    const std::size_t ahead = std::min(_offset + _window, _size);
+    if (ahead > _ahead) {
+      _mapping.advise(_ahead, ahead - _ahead, MADV_WILLNEED);
+      _ahead = ahead;
+    }
+
+    /* Drop what lies more than one window behind the current offset: */
+    if (_offset > _window) {
+      const std::size_t behind = (_offset - _window) / page_size * page_size;
+      if (behind > _behind) {
+        _mapping.advise(_behind, behind - _behind, MADV_DONTNEED);
+#ifdef POSIX_FADV_DONTNEED
+        ::posix_fadvise(fd(), static_cast<off_t>(_behind),
+          static_cast<off_t>(behind - _behind), POSIX_FADV_DONTNEED);
+#endif
+        _behind = behind;
+      }
+    }
+  }
+  catch (const posix::error&) {
+    /* Ignore any errors; these are merely hints. */
+  }
+
+  _trigger = _offset + _window / 2;
+}
+
 std::size_t
 mapped_file::seek(const off_t offset,
                   const int whence) {
 
   switch (whence) {
     case SEEK_CUR: {
-      _offset += offset; // TODO: error handling
+      /* Merely move the cursor, failing as lseek() would: */
+      if (offset < 0 && static_cast<std::size_t>(-(offset + 1)) >= _offset) {
+        throw_error(EINVAL, "seek", "%lld, %d", static_cast<long long>(offset), whence);
+      }
+      if (offset > 0 && static_cast<std::size_t>(offset) >
+          static_cast<std::size_t>(std::numeric_limits<off_t>::max()) - _offset) {
+        throw_error(EOVERFLOW, "seek", "%lld, %d", static_cast<long long>(offset), whence);
+      }
+      _offset = static_cast<std::size_t>(static_cast<off_t>(_offset) + offset);
       break;
     }
     case SEEK_SET: {
@@ -116,14 +410,28 @@ mapped_file::seek(const off_t offset,
       break;
     }
     case SEEK_END:
+      if (_capacity) {
+        /* The file extends past its logical end while preallocated: */
+        _offset = file::seek(static_cast<off_t>(_size) + offset, SEEK_SET);
+        break;
+      }
+      /* fall through */
     default: {
       _offset = file::seek(offset, whence);
-      if (_offset > _mapping.size()) {
-        // TODO: _mapping.extend();
+      /* Map through to the end of the file, should it have grown: */
+      const std::size_t file_size = file::size();
+      if (file_size > _size) {
+        remap(file_size);
+        _size = file_size;
       }
       break;
     }
   }
+  if (_window) {
+    /* Restart the streaming window at the new offset: */
+    _ahead = _behind = _offset - _offset % system_page_size();
+    slide_window();
+  }
   return _offset;
 }
 
@@ -135,14 +443,19 @@ mapped_file::read_line(std::string& buffer) {
 std::size_t
 mapped_file::read_until(const char separator,
                         std::string& buffer) {
-  std::size_t byte_count = 0;
-  char byte;
-  while (read(byte)) { /* read() updates _offset */
-    byte_count++;
-    if (byte == separator)
-      break; /* all done */
-    buffer.push_back(byte);
+  if (is_eof()) {
+    return 0; /* EOF */
   }
+
+  const char* const data = _mapping.data<char>(_offset);
+  const std::size_t available = _size - _offset;
+  const auto match = static_cast<const char*>(std::memchr(data, separator, available));
+  const std::size_t length = match ? static_cast<std::size_t>(match - data) : available;
+  buffer.append(data, length);
+
+  const std::size_t byte_count = match ? length + 1 : length;
+  _offset += byte_count;
+  advance();
   return byte_count;
 }
 
@@ -153,6 +466,7 @@ mapped_file::read(char& result) {
   }
   result = *_mapping.data<char>(_offset);
   _offset++;
+  advance();
   return 1;
 }
 
@@ -166,6 +480,7 @@ mapped_file::read(void* const buffer,
   const auto length = std::min(buffer_size, _size - _offset);
   std::memmove(buffer, _mapping.data(_offset), length);
   _offset += length;
+  advance();
   return length;
 }
 
@@ -177,6 +492,7 @@ mapped_file::read() {
     buffer.append(_mapping.data<char>(_offset), length);
     _offset += length;
     assert(is_eof());
+    advance();
   }
   return buffer;
 }
@@ -186,18 +502,20 @@ mapped_file::read() {
 appendable_mapped_file
 appendable_mapped_file::open(const pathname& pathname,
                              const int flags,
-                             const mode mode) {
+                             const mode mode,
+                             const int mapping_flags) {
 
-  return appendable_mapped_file{AT_FDCWD, pathname.c_str(), flags, mode};
+  return appendable_mapped_file{AT_FDCWD, pathname.c_str(), flags, mode, mapping_flags};
 }
 
 appendable_mapped_file
 appendable_mapped_file::open(const directory& directory,
                              const pathname& pathname,
                              const int flags,
-                             const mode mode) {
+                             const mode mode,
+                             const int mapping_flags) {
 
-  return appendable_mapped_file{directory.fd(), pathname.c_str(), flags, mode};
+  return appendable_mapped_file{directory.fd(), pathname.c_str(), flags, mode, mapping_flags};
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -209,6 +527,12 @@ appendable_mapped_file::appendable_mapped_file(appendable_mapped_file&& other) n
   std::swap(_size, other._size);
   std::swap(_offset, other._offset);
   std::swap(_mapping, other._mapping);
+  std::swap(_window, other._window);
+  std::swap(_trigger, other._trigger);
+  std::swap(_ahead, other._ahead);
+  std::swap(_behind, other._behind);
+  std::swap(_capacity, other._capacity);
+  std::swap(_chunk, other._chunk);
 }
 
 appendable_mapped_file&
@@ -218,16 +542,74 @@ appendable_mapped_file::operator=(appendable_mapped_file&& other) noexcept {
     std::swap(_size, other._size);
     std::swap(_offset, other._offset);
     std::swap(_mapping, other._mapping);
+    std::swap(_window, other._window);
+    std::swap(_trigger, other._trigger);
+    std::swap(_ahead, other._ahead);
+    std::swap(_behind, other._behind);
+    std::swap(_capacity, other._capacity);
+    std::swap(_chunk, other._chunk);
   }
   return *this;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
+void
+appendable_mapped_file::preallocate(const std::size_t chunk_size) {
+  const std::size_t page_size = system_page_size();
+
+  if (!chunk_size) {
+    if (_capacity) {
+      truncate(static_cast<off_t>(_size));
+      _chunk = _capacity = 0;
+      _mapping = memory_mapping{*this, std::max(_size, page_size), 0,
+        _mapping.protection(), _mapping.flags()};
+    }
+    return;
+  }
+
+  const bool enabled = (_capacity != 0);
+  _chunk = (chunk_size + page_size - 1) / page_size * page_size;
+  if (!enabled) {
+    try {
+      grow(_size + 1);
+    }
+    catch (...) {
+      _chunk = _capacity = 0;
+      throw;
+    }
+  }
+}
+
+void
+appendable_mapped_file::grow(const std::size_t min_capacity) {
+  const std::size_t capacity = (min_capacity + _chunk - 1) / _chunk * _chunk;
+  allocate(static_cast<off_t>(_capacity), static_cast<off_t>(capacity - _capacity));
+
+  /* Keep the caller's mapping flags, e.g. MAP_POPULATE: */
+#ifdef __linux__
+  _mapping.remap(capacity, MREMAP_MAYMOVE);
+#else
+  _mapping = memory_mapping{*this, capacity, 0, _mapping.protection(), _mapping.flags()};
+#endif
+  _capacity = capacity;
+}
+
 std::size_t
 appendable_mapped_file::append(const void* const data,
                                const std::size_t size) {
 
+  if (_capacity) {
+    const auto offset = _size;
+    if (offset + size > _capacity) {
+      grow(offset + size);
+    }
+    std::memcpy(_mapping.data(offset), data, size);
+    _size += size;
+    _offset = _size;
+    return offset;
+  }
+
   const auto offset = seek(0, SEEK_END);
 
   write(data, size);
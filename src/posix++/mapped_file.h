@@ -11,9 +11,14 @@
 
 #include "file.h"
 #include "memory_mapping.h"
+#include "string_span.h"
 
-#include <cstring> /* for std::strlen() */
-#include <string>  /* for std::string */
+#include <cassert>     /* for assert() */
+#include <cstring>     /* for std::strlen() */
+#include <functional>  /* for std::function */
+#include <string>      /* for std::string */
+#include <thread>      /* for std::thread */
+#include <type_traits> /* for std::is_trivially_copyable */
 
 namespace posix {
   class mapped_file;
@@ -24,17 +29,72 @@ namespace posix {
 
 /**
  * A memory-mapped file for random access.
+ *
+ * Files opened for reading and writing (`O_RDWR`) are mapped writable, so
+ * that they can be updated in place with `write(offset, ...)` and `at()`,
+ * and grow automatically as data is written past the end.
  */
 class posix::mapped_file : public posix::file {
 protected:
   std::size_t _size;
   std::size_t _offset;
   memory_mapping _mapping;
+  std::size_t _window{0};   /* the streaming window, or zero */
+  std::size_t _trigger{0};  /* the offset at which to slide the window */
+  std::size_t _ahead{0};    /* the end of the range read ahead */
+  std::size_t _behind{0};   /* the start of the range not yet dropped */
+  std::size_t _capacity{0}; /* the preallocated file size, or zero */
+
+  /**
+   * Slides the streaming window, if the current offset has moved far
+   * enough since the last time.
+   */
+  void advance() {
+    if (_window && _offset >= _trigger) {
+      slide_window();
+    }
+  }
+
+  void slide_window() noexcept;
+
+  /**
+   * Grows this file, if need be, to cover the given range.
+   *
+   * @throws posix::error with `EOVERFLOW` if the range end overflows
+   */
+  void cover(std::size_t offset, std::size_t size) {
+    if (offset > _size || size > _size - offset) {
+      extend(offset, size);
+    }
+  }
+
+  void extend(std::size_t offset, std::size_t size);
+
+  /**
+   * @throws posix::error with `EBADF` if the mapping is read-only
+   */
+  void require_writable(const char* origin, std::size_t offset) const;
+
+  void remap(std::size_t min_size);
 
 public:
-  static mapped_file open(const pathname& pathname, int flags, mode mode = 0);
+  /**
+   * The default streaming window size in bytes.
+   */
+  static constexpr std::size_t default_stream_window = 4 * 1024 * 1024;
+
+  /**
+   * Opens and maps a file.
+   *
+   * @param mapping_flags additional `MAP_*` flags for the mapping, e.g.
+   *                      `MAP_POPULATE` to prefault the whole file
+   */
+  static mapped_file open(const pathname& pathname, int flags, mode mode = 0, int mapping_flags = 0);
 
-  static mapped_file open(const directory& directory, const pathname& pathname, int flags, mode mode = 0);
+  /**
+   * @copydoc open(const pathname&, int, mode, int)
+   */
+  static mapped_file open(const directory& directory, const pathname& pathname, int flags, mode mode = 0, int mapping_flags = 0);
 
   /**
    * Default constructor.
@@ -45,7 +105,7 @@ public:
   /**
    * Constructor.
    */
-  mapped_file(int dirfd, const char* pathname, int flags, mode mode = 0);
+  mapped_file(int dirfd, const char* pathname, int flags, mode mode = 0, int mapping_flags = 0);
 
   /**
    * Move constructor.
@@ -57,6 +117,12 @@ public:
    */
   mapped_file& operator=(mapped_file&& other) noexcept;
 
+  /**
+   * Destructor. Truncates the file to its logical end, should it be
+   * preallocated.
+   */
+  ~mapped_file() noexcept;
+
   /**
    * Checks whether this file's size is zero.
    */
@@ -81,10 +147,86 @@ public:
   /**
    * Synchronizes the memory mapping with secondary storage.
    *
-   * @post `size()` returns the current file size
+   * If the file is preallocated past its logical end, as by
+   * `appendable_mapped_file::preallocate()`, merely flushes it, leaving
+   * `size()` as is.
+   *
+   * @post `size()` returns the current file size, or the logical size
+   *       of a preallocated file
    */
   void sync();
 
+  /**
+   * Closes this file, first truncating it to its logical end should it
+   * be preallocated.
+   *
+   * @note As `descriptor::close()` is not virtual, closing this file
+   *       through a `descriptor&` or `file&` leaves it preallocated.
+   */
+  void close() noexcept;
+
+  /**
+   * Enables or disables streaming mode, for single-pass scans.
+   *
+   * In streaming mode, the mapping is advised for sequential access;
+   * as the current file offset advances, the next `window` bytes are
+   * read ahead (`MADV_WILLNEED`), while data more than `window` bytes
+   * behind is dropped from the mapping and the page cache
+   * (`MADV_DONTNEED`, `POSIX_FADV_DONTNEED`). This keeps a scan of a file
+   * larger than memory from evicting everything else from the cache.
+   *
+   * @param window the window size in bytes, or zero to disable streaming
+   */
+  void stream(std::size_t window = default_stream_window);
+
+  /**
+   * Checks whether streaming mode is enabled.
+   */
+  bool streaming() const noexcept {
+    return _window != 0;
+  }
+
+  /**
+   * Determines which pages of this file are resident in the page cache
+   * and mapped.
+   *
+   * @throws posix::error on failure
+   * @see posix::memory_mapping::residency()
+   */
+  page_residency residency() const {
+    return _mapping.residency(0, _size);
+  }
+
+  /**
+   * Reports the progress of `prewarm()`, as the number of bytes warmed so
+   * far out of the total.
+   */
+  using prewarm_callback = std::function<void (std::size_t done, std::size_t total)>;
+
+  /**
+   * Reads a range of this file into the page cache and maps it, so that
+   * subsequent accesses to it do not incur I/O.
+   *
+   * The range is processed in chunks, each read ahead with `readahead()`
+   * (or `POSIX_FADV_WILLNEED`) and then faulted into the mapping with
+   * `MADV_POPULATE_READ` (or `MADV_WILLNEED`), calling `progress` after
+   * each chunk. Errors are ignored, as prewarming is merely advisory;
+   * should `progress` throw, prewarming stops.
+   *
+   * @param length the length of the range, or -1 for the rest of the file
+   * @param background whether to prewarm from a new thread, which is then
+   *                   returned, and calls `progress` too; the thread only
+   *                   reads the range into the page cache, through a
+   *                   duplicate of this file's descriptor, and never
+   *                   touches the mapping, which may move meanwhile
+   * @return the background thread, or a non-joinable thread otherwise
+   * @throws posix::error if the descriptor can't be duplicated
+   */
+  std::thread prewarm(std::size_t offset = 0,
+                      std::size_t length = static_cast<std::size_t>(-1),
+                      bool background = false,
+                      prewarm_callback progress = nullptr);
+
   /**
    * @copydoc posix::file::rewind()
    */
@@ -136,11 +278,139 @@ public:
     return _mapping[offset];
   }
 
+  /**
+   * Returns a reference to the object at the given offset, growing this
+   * file as needed to hold it.
+   *
+   * The reference is invalidated by anything that may move the mapping,
+   * such as a later `at()`, `write()`, or `resize()` past the end.
+   *
+   * @pre `offset` must be suitably aligned for `T`.
+   * @throws posix::error with `EBADF` if the file is not open for
+   *         reading and writing, or on any other failure
+   */
+  template <typename T>
+  T& at(const std::size_t offset) {
+    static_assert(std::is_trivially_copyable<T>::value,
+      "posix::mapped_file::at() requires a trivially copyable type");
+    assert(offset % alignof(T) == 0);
+    require_writable("posix::mapped_file::at", offset);
+    cover(offset, sizeof(T));
+    return *_mapping.data<T>(offset);
+  }
+
+  /**
+   * Returns a reference to the object at the given offset.
+   *
+   * @pre `offset + sizeof(T) <= size()`
+   * @pre `offset` must be suitably aligned for `T`.
+   */
+  template <typename T>
+  const T& at(const std::size_t offset) const noexcept {
+    static_assert(std::is_trivially_copyable<T>::value,
+      "posix::mapped_file::at() requires a trivially copyable type");
+    assert(offset % alignof(T) == 0);
+    assert(offset <= _size && sizeof(T) <= _size - offset);
+    return *_mapping.data<T>(offset);
+  }
+
+  /**
+   * Changes the file size, with `ftruncate()`, and extends the mapping
+   * to match. Any added bytes are zero-filled.
+   *
+   * @throws posix::error with `EBADF` if the file is not open for
+   *         reading and writing, or on any other failure
+   */
+  void resize(std::size_t new_size);
+
+  using file::write;
+
+  /**
+   * Writes data into the mapping at the given offset, growing this file
+   * as needed. The underlying file offset is unaffected.
+   *
+   * @throws posix::error with `EBADF` if the file is not open for
+   *         reading and writing, or on any other failure
+   */
+  void write(std::size_t offset, const void* data, std::size_t size);
+
+  /**
+   * @copydoc write(std::size_t, const void*, std::size_t)
+   */
+  void write(const std::size_t offset, const std::string& data) {
+    write(offset, data.data(), data.size());
+  }
+
+  /**
+   * Flushes changes to a range of this file back to secondary storage.
+   *
+   * @param flags the `MS_*` flags, as for `memory_mapping::sync()`
+   * @throws posix::error on failure
+   */
+  void flush(std::size_t offset, std::size_t length, int flags = MS_SYNC) {
+    _mapping.sync(offset, length, flags);
+  }
+
+  /**
+   * Flushes all changes to this file back to secondary storage.
+   *
+   * @copydetails flush(std::size_t, std::size_t, int)
+   */
+  void flush(const int flags = MS_SYNC) {
+    _mapping.sync(0, _size, flags);
+  }
+
   /**
    * Returns or changes the current file offset.
    */
   std::size_t seek(off_t offset, int whence = SEEK_SET);
 
+  /**
+   * Returns a range over the lines of this entire file, regardless of the
+   * current file offset. The lines point straight into the mapping, and
+   * are valid for as long as it is.
+   *
+   * @see posix::string_split
+   */
+  string_split lines() const noexcept {
+    return split('\n');
+  }
+
+  /**
+   * Returns a range over the records of this entire file delimited by the
+   * given separator, regardless of the current file offset. The records
+   * point straight into the mapping, and are valid for as long as it is.
+   *
+   * @see posix::string_split
+   */
+  string_split split(const char separator) const noexcept {
+    return string_split{_mapping.data<char>(), _size, separator};
+  }
+
+  /**
+   * Processes a record of this file in `parallel_for_each_record()`.
+   */
+  using record_callback = std::function<void (string_span record)>;
+
+  /**
+   * Calls `callback` on each record of this entire file delimited by the
+   * given separator, from multiple threads at once.
+   *
+   * The mapping is split into roughly equal chunks, one per thread, each
+   * extended to the next separator so that no record straddles two
+   * chunks. The records are those of `split()`; within a chunk they are
+   * processed in order, but chunks are processed concurrently, so the
+   * callback must be thread-safe. The calling thread processes the first
+   * chunk itself.
+   *
+   * @param nthreads the number of threads, or 0 for one per CPU
+   * @throws any exception thrown by `callback`, after all threads have
+   *         finished; each thread stops at its first exception
+   */
+  void parallel_for_each_record(char separator,
+                                unsigned int nthreads,
+                                const record_callback& callback) const;
+
   /**
    * Reads a line of text from this file.
    */
@@ -174,10 +444,20 @@ public:
  * A memory-mapped file for append-only writes.
  */
 class posix::appendable_mapped_file : public posix::mapped_file {
+protected:
+  std::size_t _chunk{0}; /* the preallocation chunk size, or zero */
+
+  void grow(std::size_t min_capacity);
+
 public:
-  static appendable_mapped_file open(const pathname& pathname, int flags, mode mode = 0);
+  /**
+   * The default preallocation chunk size in bytes.
+   */
+  static constexpr std::size_t default_append_chunk = 64 * 1024 * 1024;
 
-  static appendable_mapped_file open(const directory& directory, const pathname& pathname, int flags, mode mode = 0);
+  static appendable_mapped_file open(const pathname& pathname, int flags, mode mode = 0, int mapping_flags = 0);
+
+  static appendable_mapped_file open(const directory& directory, const pathname& pathname, int flags, mode mode = 0, int mapping_flags = 0);
 
   /**
    * Default constructor.
@@ -200,6 +480,32 @@ public:
    */
   appendable_mapped_file& operator=(appendable_mapped_file&& other) noexcept;
 
+  /**
+   * Enables or disables preallocation, for high-throughput appends.
+   *
+   * With preallocation, the file is extended in chunks of `chunk_size`
+   * bytes with `file::allocate()` and mapped writable, so that `append()`
+   * merely copies records into the mapping, without any system calls
+   * until a chunk fills up and the mapping is grown with
+   * `memory_mapping::remap()`. Meanwhile, the file on disk extends to the
+   * end of the last chunk; `size()` reports its logical end, to which it
+   * is truncated when preallocation is disabled, or on `close()` or
+   * destruction. `sync()` and `seek()` likewise respect the logical end.
+   *
+   * @param chunk_size the chunk size in bytes, rounded up to a multiple of
+   *                   the page size, or zero to disable preallocation
+   * @pre The file must be open for reading and writing.
+   * @throws posix::error on failure
+   */
+  void preallocate(std::size_t chunk_size = default_append_chunk);
+
+  /**
+   * Checks whether preallocation is enabled.
+   */
+  bool preallocating() const noexcept {
+    return _capacity != 0;
+  }
+
   /**
    * @throws posix::runtime_error if an error occurs
    */
@@ -217,6 +523,9 @@ public:
   }
 
   /**
+   * Appends data to the end of this file.
+   *
+   * @return the offset at which the data was appended
    * @throws posix::runtime_error if an error occurs
    */
   std::size_t append(const void* data, std::size_t size);
@@ -7,28 +7,140 @@
 #include "error.h"
 #include "descriptor.h"
 #include "memory_mapping.h"
+#include "numa_policy.h"
 
+#include <algorithm>   /* for std::min() */
 #include <cassert>     /* for assert() */
 #include <cerrno>      /* for errno */
-#include <sys/mman.h>  /* for mmap(), mremap(), munmap() */
+#include <cstdio>      /* for std::fclose(), std::fgets(), std::fopen(), std::sscanf() */
+#include <sys/mman.h>  /* for madvise(), mincore(), mmap(), mremap(), msync(), munmap() */
 #include <sys/stat.h>  /* for fstat() */
 #include <sys/types.h> /* for struct stat */
+#include <unistd.h>    /* for _SC_PAGE_SIZE, sysconf() */
+
+#if !defined(MAP_ANONYMOUS) && defined(MAP_ANON)
+#define MAP_ANONYMOUS MAP_ANON /* macOS, older BSDs */
+#endif
 
 using namespace posix;
 
+namespace {
+  std::size_t
+  round_up(const std::size_t size,
+           const std::size_t alignment) noexcept {
+    return (size + alignment - 1) / alignment * alignment;
+  }
+
+  std::size_t
+  read_huge_page_size() noexcept {
+    std::size_t size_kb = 0;
+#ifdef __linux__
+    std::FILE* const meminfo = std::fopen("/proc/meminfo", "r");
+    if (meminfo) {
+      char line[256];
+      while (std::fgets(line, sizeof(line), meminfo)) {
+        if (std::sscanf(line, "Hugepagesize: %zu kB", &size_kb) == 1) break;
+      }
+      std::fclose(meminfo);
+    }
+#endif
+    return size_kb * 1024;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+memory_mapping
+memory_mapping::anonymous(const std::size_t size,
+                          const int prot,
+                          const int flags) {
+  return memory_mapping{-1, size, 0, prot, flags | MAP_ANONYMOUS};
+}
+
+memory_mapping
+memory_mapping::huge(const std::size_t size,
+                     std::size_t page_size,
+                     const int prot,
+                     const int flags) {
+  assert(size > 0);
+  assert(page_size == 0 || (page_size & (page_size - 1)) == 0);
+
+  const bool explicit_page_size = (page_size != 0);
+  if (!page_size) {
+    page_size = huge_page_size();
+  }
+  if (!page_size) {
+    return anonymous(size, prot, flags); /* no huge page support */
+  }
+  const std::size_t rounded_size = round_up(size, page_size);
+
+#ifdef MAP_HUGETLB
+  int hugetlb_flags = flags | MAP_ANONYMOUS | MAP_HUGETLB;
+#ifdef MAP_HUGE_SHIFT
+  if (explicit_page_size) {
+    hugetlb_flags |= __builtin_ctzll(page_size) << MAP_HUGE_SHIFT;
+  }
+#endif
+  void* const addr = ::mmap(nullptr, rounded_size, prot, hugetlb_flags, -1, 0);
+  if (addr != MAP_FAILED) {
+    return memory_mapping{addr, rounded_size, prot, hugetlb_flags};
+  }
+  switch (errno) {
+    case ENOMEM: /* Cannot allocate memory; the huge page pool is exhausted */
+    case EINVAL: /* Invalid argument; no such huge page size */
+    case EPERM:  /* Operation not permitted */
+      break;     /* fall back to transparent huge pages */
+    default:
+      throw_error("mmap", "%s, %zu, 0x%x, 0x%x, %d, %d", "NULL", rounded_size,
+        static_cast<unsigned int>(prot), static_cast<unsigned int>(hugetlb_flags), -1, 0);
+  }
+#else
+  (void)explicit_page_size;
+#endif /* MAP_HUGETLB */
+
+  /* Over-allocate, so as to trim the mapping to a huge page boundary: */
+  memory_mapping mapping = anonymous(rounded_size + page_size, prot, flags);
+  std::uint8_t* const base = mapping._data;
+  std::uint8_t* const aligned = reinterpret_cast<std::uint8_t*>(
+    round_up(reinterpret_cast<std::uintptr_t>(base), page_size));
+  if (aligned != base) {
+    ::munmap(base, static_cast<std::size_t>(aligned - base));
+  }
+  const std::size_t tail = static_cast<std::size_t>(base + mapping._size - (aligned + rounded_size));
+  if (tail) {
+    ::munmap(aligned + rounded_size, tail);
+  }
+  mapping._data = aligned;
+  mapping._size = rounded_size;
+
+#ifdef MADV_HUGEPAGE
+  if (::madvise(aligned, rounded_size, MADV_HUGEPAGE) == -1) {
+    /* Ignore any errors from madvise(); this is merely a hint. */
+  }
+#endif
+  return mapping;
+}
+
+std::size_t
+memory_mapping::huge_page_size() noexcept {
+  static const std::size_t size = read_huge_page_size();
+  return size;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 
 std::uint8_t*
 memory_mapping::map(const int fd,
                     const std::size_t size,
-                    const std::size_t offset) {
+                    const std::size_t offset,
+                    void* const address) {
+#ifdef MAP_ANONYMOUS
+  assert(fd >= 0 || (_flags & MAP_ANONYMOUS));
+#else
   assert(fd >= 0);
+#endif
   assert(size > 0);
 
-  const int prot = PROT_READ; // FIXME
-
-  const int flags = MAP_SHARED;
-
   if (size == static_cast<std::size_t>(-1)) {
     struct stat st;
     if (fstat(fd, &st) == -1) {
@@ -40,16 +152,37 @@ memory_mapping::map(const int fd,
     _size = size;
   }
 
-  void* const addr = ::mmap(nullptr, _size, prot, flags, fd, offset);
+  void* const addr = ::mmap(address, _size, _prot, _flags, fd, static_cast<off_t>(offset));
   if (addr == MAP_FAILED) {
     throw_error("mmap", "%p, %zu, 0x%x, 0x%x, %d, %zu",
-      nullptr, _size, static_cast<unsigned int>(prot),
-      static_cast<unsigned int>(flags), fd, offset);
+      address, _size, static_cast<unsigned int>(_prot),
+      static_cast<unsigned int>(_flags), fd, offset);
   }
 
+#ifdef MAP_FIXED_NOREPLACE
+  /* Kernels predating Linux 4.17 treat the flag as a mere hint: */
+  if ((_flags & MAP_FIXED_NOREPLACE) && addr != address) {
+    ::munmap(addr, _size);
+    throw_error(EEXIST, "mmap", "%p, %zu, 0x%x, 0x%x, %d, %zu",
+      address, _size, static_cast<unsigned int>(_prot),
+      static_cast<unsigned int>(_flags), fd, offset);
+  }
+#endif
+
   return reinterpret_cast<std::uint8_t*>(addr);
 }
 
+void
+memory_mapping::unmap() noexcept {
+  if (_data) {
+    if (::munmap(reinterpret_cast<void*>(_data), _size) == -1) {
+      /* Ignore any errors from munmap() here. */
+    }
+    _data = nullptr;
+    _size = 0;
+  }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 
 memory_mapping::memory_mapping(const descriptor& descriptor)
@@ -60,29 +193,67 @@ memory_mapping::memory_mapping(const descriptor& descriptor,
                                const std::size_t offset)
   : memory_mapping{descriptor.fd(), size, offset} {}
 
+memory_mapping::memory_mapping(const descriptor& descriptor,
+                               const std::size_t size,
+                               const std::size_t offset,
+                               const int prot,
+                               const int flags,
+                               void* const address)
+  : memory_mapping{descriptor.fd(), size, offset, prot, flags, address} {}
+
 memory_mapping::memory_mapping(const int fd)
-  : _size{0},
-    _data{map(fd, static_cast<std::size_t>(-1), 0)} {}
+  : memory_mapping{fd, static_cast<std::size_t>(-1), 0} {}
 
 memory_mapping::memory_mapping(const int fd,
                                const std::size_t size,
                                const std::size_t offset)
+  : memory_mapping{fd, size, offset, PROT_READ, MAP_SHARED} {}
+
+memory_mapping::memory_mapping(const int fd,
+                               const std::size_t size,
+                               const std::size_t offset,
+                               const int prot,
+                               const int flags,
+                               void* const address)
   : _size{size},
-    _data{map(fd, size, offset)} {}
+    _prot{prot},
+    _flags{flags},
+    _data{map(fd, size, offset, address)} {}
 
 memory_mapping::memory_mapping(void* const data,
-                               const std::size_t size) noexcept
+                               const std::size_t size,
+                               const int prot,
+                               const int flags) noexcept
   : _size{size},
+    _prot{prot},
+    _flags{flags},
     _data{reinterpret_cast<std::uint8_t*>(data)} {}
 
-memory_mapping::~memory_mapping() noexcept {
-  if (_data) {
-    if (::munmap(reinterpret_cast<void*>(_data), _size) == -1) {
-      /* Ignore any errors from munmap() here. */
-    }
-    _data = nullptr;
-    _size = 0;
+memory_mapping::memory_mapping(memory_mapping&& other) noexcept
+  : _size{other._size},
+    _prot{other._prot},
+    _flags{other._flags},
+    _data{other._data} {
+  other._data = nullptr;
+  other._size = 0;
+}
+
+memory_mapping&
+memory_mapping::operator=(memory_mapping&& other) noexcept {
+  if (this != &other) {
+    unmap();
+    _size = other._size;
+    _prot = other._prot;
+    _flags = other._flags;
+    _data = other._data;
+    other._data = nullptr;
+    other._size = 0;
   }
+  return *this;
+}
+
+memory_mapping::~memory_mapping() noexcept {
+  unmap();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -93,7 +264,7 @@ memory_mapping::remap(const std::size_t new_size,
 #ifdef __linux__
   void* const new_addr = ::mremap(_data, _size, new_size, flags);
   if (new_addr == MAP_FAILED) {
-    throw_error("mremap", "%p, %zu, %zu, 0x%",
+    throw_error("mremap", "%p, %zu, %zu, 0x%x",
       _data, _size, new_size, static_cast<unsigned int>(flags));
   }
   _data = reinterpret_cast<std::uint8_t*>(new_addr);
@@ -103,17 +274,139 @@ memory_mapping::remap(const std::size_t new_size,
 #endif /* __linux__ */
 }
 
+void
+memory_mapping::sync(const int flags) {
+  sync(0, _size, flags);
+}
+
+void
+memory_mapping::sync(std::size_t offset,
+                     std::size_t length,
+                     const int flags) {
+  if (offset >= _size || !length) {
+    return; /* nothing to do */
+  }
+
+  /* Widen the range to page boundaries, as msync() requires: */
+  static const std::size_t page_size = static_cast<std::size_t>(::sysconf(_SC_PAGE_SIZE));
+  length = std::min(length, _size - offset) + (offset % page_size);
+  offset -= offset % page_size;
+
+retry:
+  if (::msync(_data + offset, length, flags) == -1) {
+    switch (errno) {
+      case EINTR: /* Interrupted system call */
+        goto retry;
+      default:
+        throw_error("msync", "%p, %zu, 0x%x",
+          _data + offset, length, static_cast<unsigned int>(flags));
+    }
+  }
+}
+
+bool
+memory_mapping::hugetlb() const noexcept {
+#ifdef MAP_HUGETLB
+  return _data != nullptr && (_flags & MAP_HUGETLB);
+#else
+  return false;
+#endif
+}
+
+void
+memory_mapping::advise(const int advice) {
+  advise(0, _size, advice);
+}
+
+void
+memory_mapping::advise(std::size_t offset,
+                       std::size_t length,
+                       const int advice) {
+  if (offset >= _size || !length) {
+    return; /* nothing to do */
+  }
+
+  /* Widen the range to page boundaries, as madvise() requires: */
+  static const std::size_t page_size = static_cast<std::size_t>(::sysconf(_SC_PAGE_SIZE));
+  length = std::min(length, _size - offset) + (offset % page_size);
+  offset -= offset % page_size;
+
+  if (::madvise(_data + offset, length, advice) == -1) {
+    throw_error("madvise", "%p, %zu, %d", _data + offset, length, advice);
+  }
+}
+
+page_residency
+memory_mapping::residency() const {
+  return residency(0, _size);
+}
+
+page_residency
+memory_mapping::residency(std::size_t offset,
+                          std::size_t length) const {
+  static const std::size_t page_size = static_cast<std::size_t>(::sysconf(_SC_PAGE_SIZE));
+
+  page_residency result{page_size, std::vector<bool>{}};
+  if (offset >= _size || !length) {
+    return result; /* nothing to do */
+  }
+
+  /* Widen the range to page boundaries, as mincore() requires: */
+  length = std::min(length, _size - offset) + (offset % page_size);
+  offset -= offset % page_size;
+
+#ifdef __linux__
+  std::vector<unsigned char> vec((length + page_size - 1) / page_size);
+#else
+  std::vector<char> vec((length + page_size - 1) / page_size);
+#endif
+  if (::mincore(_data + offset, length, vec.data()) == -1) {
+    throw_error("mincore", "%p, %zu, %s", _data + offset, length, "vec");
+  }
+
+  result.pages.reserve(vec.size());
+  for (const auto page : vec) {
+    result.pages.push_back((page & 1) != 0);
+  }
+  return result;
+}
+
+void
+memory_mapping::advise_huge_pages(const bool enable) {
+#ifdef MADV_HUGEPAGE
+  const int advice = enable ? MADV_HUGEPAGE : MADV_NOHUGEPAGE;
+  if (::madvise(_data, _size, advice) == -1) {
+    throw_error("madvise", "%p, %zu, %s", _data, _size,
+      enable ? "MADV_HUGEPAGE" : "MADV_NOHUGEPAGE");
+  }
+#else
+  (void)enable;
+  throw_error(ENOSYS); /* Function not implemented */
+#endif /* MADV_HUGEPAGE */
+}
+
+void
+memory_mapping::set_numa_policy(const numa_policy& policy,
+                                const bool move) {
+  policy.apply(_data, _size, move);
+}
+
+std::vector<int>
+memory_mapping::numa_placement() const {
+  return numa_policy::placement(_data, _size);
+}
+
 bool
 memory_mapping::readable() const noexcept {
-  return _data != nullptr; // TODO
+  return _data != nullptr && (_prot & PROT_READ);
 }
 
 bool
 memory_mapping::writable() const noexcept {
-  return _data != nullptr; // TODO
+  return _data != nullptr && (_prot & PROT_WRITE);
 }
 
 bool
 memory_mapping::executable() const noexcept {
-  return _data != nullptr; // TODO
+  return _data != nullptr && (_prot & PROT_EXEC);
 }
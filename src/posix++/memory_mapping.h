@@ -9,31 +9,109 @@
 
 ////////////////////////////////////////////////////////////////////////////////
 
-#include <cstddef> /* for std::size_t */
-#include <cstdint> /* for std::uint8_t */
+#include <algorithm>  /* for std::count() */
+#include <cstddef>    /* for std::size_t */
+#include <cstdint>    /* for std::uint8_t */
+#include <sys/mman.h> /* for MAP_*, PROT_* */
+#include <vector>     /* for std::vector */
 
 namespace posix {
   struct descriptor;
   class memory_mapping;
+  class numa_policy;
+  struct page_residency;
 }
 
 
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Describes which pages of a memory range are resident in memory.
+ *
+ * @see posix::memory_mapping::residency()
+ */
+struct posix::page_residency {
+  /**
+   * The page size in bytes.
+   */
+  std::size_t page_size;
+
+  /**
+   * Whether each page of the range is resident.
+   */
+  std::vector<bool> pages;
+
+  /**
+   * Returns the number of resident pages.
+   */
+  std::size_t resident_count() const {
+    return static_cast<std::size_t>(std::count(pages.begin(), pages.end(), true));
+  }
+
+  /**
+   * Returns the percentage of resident pages, from 0 to 100.
+   */
+  double percentage() const {
+    return pages.empty() ? 100.0 : 100.0 * resident_count() / pages.size();
+  }
+};
+
 ////////////////////////////////////////////////////////////////////////////////
 
 /**
  * Represents a POSIX memory mapping.
  *
+ * Unless otherwise specified, mappings are created read-only
+ * (`PROT_READ`) and shared (`MAP_SHARED`).
+ *
  * @see http://en.wikipedia.org/wiki/Memory-mapped_file
+ * @see http://pubs.opengroup.org/onlinepubs/9699919799/functions/mmap.html
  */
 class posix::memory_mapping {
 protected:
   std::size_t _size;
+  int _prot;
+  int _flags;
   std::uint8_t* _data;
 
 protected:
-  std::uint8_t* map(int fd, std::size_t size, std::size_t offset);
+  std::uint8_t* map(int fd, std::size_t size, std::size_t offset, void* address = nullptr);
+
+  void unmap() noexcept;
 
 public:
+  /**
+   * Creates an anonymous mapping, zero-filled and not backed by any file.
+   *
+   * @throws posix::error on failure
+   */
+  static memory_mapping anonymous(std::size_t size,
+    int prot = PROT_READ | PROT_WRITE, int flags = MAP_PRIVATE);
+
+  /**
+   * Creates an anonymous mapping backed by huge pages.
+   *
+   * The size is rounded up to a multiple of the huge page size. Explicit
+   * huge pages (`MAP_HUGETLB`) are tried first; should the huge page pool
+   * be exhausted or unavailable, falls back to a regular mapping aligned
+   * on a huge page boundary and advised for transparent huge pages
+   * (`MADV_HUGEPAGE`). Use `hugetlb()` to find out which was obtained.
+   *
+   * @param page_size the huge page size, e.g. 2 MiB or 1 GiB, or zero for
+   *                  the system default
+   * @throws posix::error on failure
+   * @note Huge pages are Linux-specific. On other platforms, this returns
+   *       a regular anonymous mapping.
+   */
+  static memory_mapping huge(std::size_t size, std::size_t page_size = 0,
+    int prot = PROT_READ | PROT_WRITE, int flags = MAP_PRIVATE);
+
+  /**
+   * Returns the default huge page size, or zero if huge pages are not
+   * supported.
+   */
+  static std::size_t huge_page_size() noexcept;
+
   /**
    * Default constructor.
    */
@@ -70,9 +148,35 @@ public:
   /**
    * Constructor.
    *
-   * @throws posix::error on failure
+   * The `prot` argument accepts `PROT_READ`, `PROT_WRITE`, and
+   * `PROT_EXEC`, or `PROT_NONE`. The `flags` argument must include one of
+   * `MAP_SHARED` or `MAP_PRIVATE`, and may include `MAP_POPULATE` to
+   * prefault the mapping, `MAP_NORESERVE`, and `MAP_FIXED_NOREPLACE`
+   * along with the `address` at which to place the mapping.
+   *
+   * @param size the size of the mapping, or -1 for the rest of the file
+   * @param address the address hint, or `nullptr`
+   * @throws posix::error on failure, e.g. `EEXIST` if the mapping would
+   *         replace an existing one at `address` under `MAP_FIXED_NOREPLACE`
    */
-  memory_mapping(void* data, std::size_t size) noexcept;
+  memory_mapping(int fd, std::size_t size, std::size_t offset,
+    int prot, int flags, void* address = nullptr);
+
+  /**
+   * Constructor.
+   *
+   * @copydetails memory_mapping(int, std::size_t, std::size_t, int, int, void*)
+   */
+  memory_mapping(const descriptor& descriptor, std::size_t size, std::size_t offset,
+    int prot, int flags, void* address = nullptr);
+
+  /**
+   * Constructor. Takes ownership of an existing mapping, which is
+   * assumed to be readable, writable, and shared unless otherwise
+   * specified.
+   */
+  memory_mapping(void* data, std::size_t size,
+    int prot = PROT_READ | PROT_WRITE, int flags = MAP_SHARED) noexcept;
 
   /**
    * Copy constructor.
@@ -82,7 +186,7 @@ public:
   /**
    * Move constructor.
    */
-  memory_mapping(memory_mapping&& other) noexcept = default;
+  memory_mapping(memory_mapping&& other) noexcept;
 
   /**
    * Copy assignment operator.
@@ -92,13 +196,25 @@ public:
   /**
    * Move assignment operator.
    */
-  memory_mapping& operator=(memory_mapping&& other) noexcept = default;
+  memory_mapping& operator=(memory_mapping&& other) noexcept;
 
   /**
    * Destructor.
    */
   ~memory_mapping() noexcept;
 
+  /**
+   * Releases the ownership of the mapped memory and returns it.
+   *
+   * @post This mapping is in an invalid state.
+   */
+  void* release() noexcept {
+    void* const data = _data;
+    _data = nullptr;
+    _size = 0;
+    return data;
+  }
+
   /**
    * Expands or shrinks this mapping.
    *
@@ -113,6 +229,124 @@ public:
     return _size;
   }
 
+  /**
+   * Returns the `PROT_*` memory protection of the mapping.
+   */
+  int protection() const noexcept {
+    return _prot;
+  }
+
+  /**
+   * Returns the `MAP_*` flags the mapping was created with.
+   */
+  int flags() const noexcept {
+    return _flags;
+  }
+
+  /**
+   * Checks whether changes to this mapping are visible to other mappings
+   * of the same file and carried through to it.
+   */
+  bool shared() const noexcept {
+    return (_flags & MAP_SHARED) != 0;
+  }
+
+  /**
+   * Flushes changes to this entire mapping back to the mapped file.
+   *
+   * @copydetails sync(std::size_t, std::size_t, int)
+   */
+  void sync(int flags = MS_SYNC);
+
+  /**
+   * Flushes changes to a range of this mapping back to the mapped file.
+   * The range is widened to page boundaries and clamped to the mapping.
+   *
+   * The `flags` argument must include one of `MS_SYNC`, which waits for
+   * the writeback to complete, or `MS_ASYNC`, which merely schedules it,
+   * and may include `MS_INVALIDATE` to have other mappings of the file
+   * reflect its current contents.
+   *
+   * @throws posix::error on failure
+   * @see http://pubs.opengroup.org/onlinepubs/9699919799/functions/msync.html
+   * @see posix::dirty_tracker
+   */
+  void sync(std::size_t offset, std::size_t length, int flags = MS_SYNC);
+
+  /**
+   * Checks whether this mapping is backed by explicit huge pages
+   * (`MAP_HUGETLB`), as opposed to regular or transparent huge pages.
+   */
+  bool hugetlb() const noexcept;
+
+  /**
+   * Advises the kernel about the expected usage of this entire mapping.
+   *
+   * @copydetails advise(std::size_t, std::size_t, int)
+   */
+  void advise(int advice);
+
+  /**
+   * Advises the kernel about the expected usage of a range of this
+   * mapping. The range is widened to page boundaries and clamped to the
+   * mapping.
+   *
+   * The `advice` argument accepts the `MADV_*` constants, including
+   * `MADV_NORMAL`, `MADV_SEQUENTIAL`, `MADV_RANDOM`, `MADV_WILLNEED`,
+   * `MADV_DONTNEED`, and, on Linux, `MADV_COLD`, `MADV_PAGEOUT`, and
+   * `MADV_POPULATE_READ` where supported by the kernel.
+   *
+   * @throws posix::error on failure, e.g. `EINVAL` for advice unknown
+   *         to the kernel
+   * @see http://man7.org/linux/man-pages/man2/madvise.2.html
+   */
+  void advise(std::size_t offset, std::size_t length, int advice);
+
+  /**
+   * Determines which pages of this entire mapping are resident in memory,
+   * i.e., would not incur a page fault requiring I/O when accessed.
+   *
+   * @throws posix::error on failure
+   */
+  page_residency residency() const;
+
+  /**
+   * Determines which pages of a range of this mapping are resident in
+   * memory. The range is widened to page boundaries and clamped to the
+   * mapping.
+   *
+   * @throws posix::error on failure
+   * @see http://man7.org/linux/man-pages/man2/mincore.2.html
+   */
+  page_residency residency(std::size_t offset, std::size_t length) const;
+
+  /**
+   * Enables or disables transparent huge pages for this mapping.
+   *
+   * @throws posix::error on failure, e.g. `EINVAL` if transparent huge
+   *         pages are disabled system-wide
+   * @note This operation is Linux-specific.
+   */
+  void advise_huge_pages(bool enable = true);
+
+  /**
+   * Applies a NUMA placement policy to this mapping, so that its pages
+   * are allocated from the policy's nodes when first touched.
+   *
+   * @param move whether to also migrate pages already allocated
+   * @throws posix::error on failure
+   * @note This does nothing on machines with a single NUMA node.
+   */
+  void set_numa_policy(const numa_policy& policy, bool move = false);
+
+  /**
+   * Returns the NUMA node on which each page of this mapping resides.
+   *
+   * @throws posix::error on failure
+   * @see posix::numa_policy::placement()
+   */
+  std::vector<int> numa_placement() const;
+
   /**
    * Returns a pointer to the mapped memory.
    */
@@ -168,7 +402,7 @@ public:
   bool writable() const noexcept;
 
   /**
-   * Checks whether this memory mapping is writable.
+   * Checks whether this memory mapping is executable.
    */
   bool executable() const noexcept;
 };
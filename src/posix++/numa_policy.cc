@@ -0,0 +1,214 @@
+/* This is free and unencumbered software released into the public domain. */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "numa_policy.h"
+
+#include "error.h"
+
+#include <cassert>  /* for assert() */
+#include <cerrno>   /* for ENOSYS, errno */
+#include <climits>  /* for CHAR_BIT */
+#include <cstdint>  /* for std::uintptr_t */
+#include <cstdio>   /* for std::fclose(), std::fgetc(), std::fopen(), std::fscanf() */
+#include <unistd.h> /* for _SC_PAGE_SIZE, syscall(), sysconf() */
+
+#ifdef __linux__
+#include <linux/mempolicy.h> /* for MPOL_* */
+#include <sys/syscall.h>     /* for __NR_mbind, __NR_move_pages, __NR_set_mempolicy */
+#if defined(__NR_mbind) && defined(__NR_set_mempolicy) && defined(__NR_move_pages)
+#define POSIXXX_NUMA 1
+#endif
+#endif
+
+#ifndef POSIXXX_NUMA
+enum { MPOL_DEFAULT, MPOL_PREFERRED, MPOL_BIND, MPOL_INTERLEAVE };
+#endif
+
+using namespace posix;
+
+namespace {
+  constexpr std::size_t bits_per_long = sizeof(unsigned long) * CHAR_BIT;
+
+  std::size_t
+  page_size() noexcept {
+    return static_cast<std::size_t>(::sysconf(_SC_PAGE_SIZE));
+  }
+
+  std::vector<int>
+  read_online_nodes() {
+    std::vector<int> nodes;
+#ifdef POSIXXX_NUMA
+    /* The node list is formatted as, e.g., "0-1,3": */
+    std::FILE* const stream = std::fopen("/sys/devices/system/node/online", "r");
+    if (stream) {
+      int first, last;
+      while (std::fscanf(stream, "%d", &first) == 1) {
+        last = first;
+        int c = std::fgetc(stream);
+        if (c == '-') {
+          if (std::fscanf(stream, "%d", &last) != 1) break;
+          c = std::fgetc(stream);
+        }
+        for (int node = first; node <= last; node++) {
+          nodes.push_back(node);
+        }
+        if (c != ',') break;
+      }
+      std::fclose(stream);
+    }
+#endif
+    if (nodes.empty()) {
+      nodes.push_back(0);
+    }
+    return nodes;
+  }
+
+  const std::vector<int>&
+  online_nodes() {
+    static const std::vector<int> nodes = read_online_nodes();
+    return nodes;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+std::size_t
+numa_policy::node_count() noexcept {
+  try {
+    return online_nodes().size();
+  }
+  catch (...) {
+    return 1;
+  }
+}
+
+numa_policy
+numa_policy::default_policy() {
+  return numa_policy{MPOL_DEFAULT, std::vector<int>{}};
+}
+
+numa_policy
+numa_policy::bind(const int node) {
+  return numa_policy{MPOL_BIND, std::vector<int>{node}};
+}
+
+numa_policy
+numa_policy::bind(const std::vector<int>& nodes) {
+  return numa_policy{MPOL_BIND, nodes};
+}
+
+numa_policy
+numa_policy::interleave() {
+  return numa_policy{MPOL_INTERLEAVE, online_nodes()};
+}
+
+numa_policy
+numa_policy::interleave(const std::vector<int>& nodes) {
+  return numa_policy{MPOL_INTERLEAVE, nodes};
+}
+
+numa_policy
+numa_policy::preferred(const int node) {
+  return numa_policy{MPOL_PREFERRED, std::vector<int>{node}};
+}
+
+std::vector<int>
+numa_policy::placement(const void* const address,
+                       const std::size_t size) {
+  const auto start = reinterpret_cast<std::uintptr_t>(address) & ~(page_size() - 1);
+  const auto end = reinterpret_cast<std::uintptr_t>(address) + size;
+  const std::size_t count = (end - start + page_size() - 1) / page_size();
+
+  std::vector<int> status(count, 0);
+  if (!count) {
+    return status;
+  }
+
+#ifdef POSIXXX_NUMA
+  std::vector<void*> pages(count);
+  for (std::size_t i = 0; i < count; i++) {
+    pages[i] = reinterpret_cast<void*>(start + i * page_size());
+  }
+  /* With a null node array, move_pages() only queries the placement: */
+  if (::syscall(__NR_move_pages, 0, count, pages.data(), nullptr, status.data(), 0) == -1) {
+    switch (errno) {
+      case ENOSYS: /* Function not implemented, i.e., CONFIG_NUMA=n */
+        break;
+      default:
+        throw_error("move_pages", "%d, %zu, %p, %s, %s, %d",
+          0, count, address, "NULL", "status", 0);
+    }
+  }
+#endif
+  return status;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+numa_policy::numa_policy(const int mode,
+                         const std::vector<int>& nodes)
+  : _mode{mode} {
+
+  for (const int node : nodes) {
+    assert(node >= 0);
+    const std::size_t index = static_cast<std::size_t>(node) / bits_per_long;
+    if (index >= _nodemask.size()) {
+      _nodemask.resize(index + 1, 0);
+    }
+    _nodemask[index] |= 1UL << (static_cast<std::size_t>(node) % bits_per_long);
+  }
+}
+
+bool
+numa_policy::contains(const int node) const noexcept {
+  if (node < 0) return false;
+  const std::size_t index = static_cast<std::size_t>(node) / bits_per_long;
+  return index < _nodemask.size() &&
+    (_nodemask[index] & (1UL << (static_cast<std::size_t>(node) % bits_per_long)));
+}
+
+void
+numa_policy::apply(void* const address,
+                   const std::size_t size,
+                   const bool move) const {
+#ifdef POSIXXX_NUMA
+  if (!supported() || !size) {
+    return; /* nothing to do */
+  }
+
+  const auto start = reinterpret_cast<std::uintptr_t>(address) & ~(page_size() - 1);
+  const auto end = reinterpret_cast<std::uintptr_t>(address) + size;
+  const unsigned long maxnode = _nodemask.size() * bits_per_long + 1;
+  const unsigned int flags = move ? MPOL_MF_MOVE : 0;
+
+  if (::syscall(__NR_mbind, start, end - start, _mode,
+        _nodemask.empty() ? nullptr : _nodemask.data(),
+        _nodemask.empty() ? 0UL : maxnode, flags) == -1) {
+    throw_error("mbind", "%p, %zu, %d, %s, %lu, 0x%x",
+      reinterpret_cast<void*>(start), static_cast<std::size_t>(end - start),
+      _mode, "nodemask", maxnode, flags);
+  }
+#else
+  (void)address, (void)size, (void)move;
+#endif /* POSIXXX_NUMA */
+}
+
+void
+numa_policy::apply() const {
+#ifdef POSIXXX_NUMA
+  if (!supported()) {
+    return; /* nothing to do */
+  }
+
+  const unsigned long maxnode = _nodemask.size() * bits_per_long + 1;
+
+  if (::syscall(__NR_set_mempolicy, _mode,
+        _nodemask.empty() ? nullptr : _nodemask.data(),
+        _nodemask.empty() ? 0UL : maxnode) == -1) {
+    throw_error("set_mempolicy", "%d, %s, %lu", _mode, "nodemask", maxnode);
+  }
+#endif /* POSIXXX_NUMA */
+}
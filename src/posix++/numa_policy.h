@@ -0,0 +1,135 @@
+/* This is free and unencumbered software released into the public domain. */
+
+#ifndef POSIXXX_NUMA_POLICY_H
+#define POSIXXX_NUMA_POLICY_H
+
+#ifndef __cplusplus
+#error "<posix++/numa_policy.h> requires a C++ compiler"
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include <cstddef> /* for std::size_t */
+#include <vector>  /* for std::vector */
+
+namespace posix {
+  class numa_policy;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * A NUMA memory placement policy, determining from which nodes the pages
+ * of a memory range are allocated when they are first touched.
+ *
+ * Policies are applied with the raw `mbind()` and `set_mempolicy()`
+ * system calls, so no dependency on `libnuma` is required. On machines
+ * with a single NUMA node, and on platforms without NUMA support,
+ * applying a policy does nothing.
+ *
+ * @see http://man7.org/linux/man-pages/man2/mbind.2.html
+ * @see posix::memory_mapping::set_numa_policy()
+ * @see posix::sysv_segment::set_numa_policy()
+ */
+class posix::numa_policy {
+protected:
+  int _mode;
+  std::vector<unsigned long> _nodemask;
+
+  numa_policy(int mode, const std::vector<int>& nodes);
+
+public:
+  /**
+   * Returns the number of online NUMA nodes, which is one on machines
+   * without NUMA support.
+   */
+  static std::size_t node_count() noexcept;
+
+  /**
+   * Checks whether NUMA policies have any effect on this machine, i.e.,
+   * whether it has more than one online node.
+   */
+  static bool supported() noexcept {
+    return node_count() > 1;
+  }
+
+  /**
+   * Returns the default policy, which allocates pages on the node of the
+   * CPU that first touches them.
+   */
+  static numa_policy default_policy();
+
+  /**
+   * Returns a policy that strictly allocates pages from the given node.
+   */
+  static numa_policy bind(int node);
+
+  /**
+   * Returns a policy that strictly allocates pages from the given nodes.
+   */
+  static numa_policy bind(const std::vector<int>& nodes);
+
+  /**
+   * Returns a policy that interleaves pages across all online nodes.
+   */
+  static numa_policy interleave();
+
+  /**
+   * Returns a policy that interleaves pages across the given nodes.
+   */
+  static numa_policy interleave(const std::vector<int>& nodes);
+
+  /**
+   * Returns a policy that allocates pages from the given node when
+   * possible, and falls back to other nodes otherwise.
+   */
+  static numa_policy preferred(int node);
+
+  /**
+   * Returns the node on which each page of the given memory range
+   * currently resides.
+   *
+   * Pages not yet faulted in are reported as `-ENOENT`, and other
+   * per-page errors likewise as negated `errno` values. On machines
+   * without NUMA support, every page is reported as residing on node 0.
+   *
+   * @throws posix::error on failure
+   */
+  static std::vector<int> placement(const void* address, std::size_t size);
+
+  /**
+   * Returns the `MPOL_*` mode of this policy.
+   */
+  int mode() const noexcept {
+    return _mode;
+  }
+
+  /**
+   * Checks whether the given node is among the nodes of this policy.
+   */
+  bool contains(int node) const noexcept;
+
+  /**
+   * Applies this policy to a memory range, which is widened to page
+   * boundaries.
+   *
+   * For shared mappings and segments, the policy applies to the shared
+   * object itself, and thus to pages first touched by other processes.
+   *
+   * @param move whether to also migrate pages already allocated
+   * @throws posix::error on failure
+   */
+  void apply(void* address, std::size_t size, bool move = false) const;
+
+  /**
+   * Applies this policy to all future allocations of the calling thread
+   * that are not covered by a memory range policy.
+   *
+   * @throws posix::error on failure
+   */
+  void apply() const;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif /* POSIXXX_NUMA_POLICY_H */
@@ -0,0 +1,115 @@
+/* This is free and unencumbered software released into the public domain. */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "poll_set.h"
+
+#include "error.h"
+
+#include <cassert> /* for assert() */
+#include <cerrno>  /* for errno */
+#include <climits> /* for INT_MAX */
+
+using namespace posix;
+
+void
+poll_set::add(const descriptor& descriptor,
+              const short events) {
+  const auto found = _index.find(descriptor.fd());
+  if (found != _index.end()) {
+    _fds[found->second].events = events;
+    return;
+  }
+
+  const struct pollfd entry = {descriptor.fd(), events, 0};
+  _fds.push_back(entry);
+  _index[descriptor.fd()] = _fds.size() - 1;
+}
+
+void
+poll_set::remove(const descriptor& descriptor) noexcept {
+  const auto found = _index.find(descriptor.fd());
+  if (found == _index.end()) {
+    return; /* not in the set */
+  }
+
+  const std::size_t index = found->second;
+  _index.erase(found);
+
+  /* Move the last entry into the vacated slot: */
+  if (index != _fds.size() - 1) {
+    _fds[index] = _fds.back();
+    _index[_fds[index].fd] = index;
+  }
+  _fds.pop_back();
+}
+
+void
+poll_set::clear() noexcept {
+  _fds.clear();
+  _ready.clear();
+  _index.clear();
+}
+
+std::size_t
+poll_set::wait(const int timeout) {
+retry:
+  const int rc = ::poll(_fds.data(), _fds.size(), timeout);
+  if (rc == -1) {
+    switch (errno) {
+      case EINTR: /* Interrupted system call */
+        goto retry;
+      default:
+        assert(errno != EFAULT);
+        throw_error("poll", "%s, %zu, %d", "fds", _fds.size(), timeout);
+    }
+  }
+  return collect(rc);
+}
+
+std::size_t
+poll_set::wait(const struct timespec* const timeout,
+               const sigset_t* const sigmask) {
+#ifdef HAVE_PPOLL
+retry:
+  const int rc = ::ppoll(_fds.data(), _fds.size(), timeout, sigmask);
+  if (rc == -1) {
+    switch (errno) {
+      case EINTR: /* Interrupted system call */
+        if (!sigmask) goto retry;
+        return collect(0);
+      default:
+        assert(errno != EFAULT);
+        throw_error("ppoll", "%s, %zu, %p, %p", "fds", _fds.size(), timeout, sigmask);
+    }
+  }
+  return collect(rc);
+#else
+  if (sigmask) {
+    throw_error(ENOSYS); /* Function not implemented */
+  }
+  if (!timeout) {
+    return wait(-1);
+  }
+  /* Round up to the next millisecond, so as not to wake up early: */
+  const long long milliseconds = static_cast<long long>(timeout->tv_sec) * 1000 +
+    (timeout->tv_nsec + 999999) / 1000000;
+  return wait(milliseconds > INT_MAX ? INT_MAX : static_cast<int>(milliseconds));
+#endif /* HAVE_PPOLL */
+}
+
+std::size_t
+poll_set::collect(const int count) {
+  _ready.clear();
+  if (count > 0) {
+    _ready.reserve(static_cast<std::size_t>(count));
+    for (const auto& entry : _fds) {
+      if (entry.revents) {
+        _ready.push_back(entry);
+      }
+    }
+  }
+  return _ready.size();
+}
@@ -0,0 +1,142 @@
+/* This is free and unencumbered software released into the public domain. */
+
+#ifndef POSIXXX_POLL_SET_H
+#define POSIXXX_POLL_SET_H
+
+#ifndef __cplusplus
+#error "<posix++/poll_set.h> requires a C++ compiler"
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include "descriptor.h"
+
+#include <cstddef>       /* for std::size_t */
+#include <ctime>         /* for struct timespec */
+#include <poll.h>        /* for POLL*, struct pollfd */
+#include <signal.h>      /* for sigset_t */
+#include <unordered_map> /* for std::unordered_map */
+#include <vector>        /* for std::vector */
+
+namespace posix {
+  class poll_set;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * A set of descriptors polled together with a single `poll()` call.
+ *
+ * The descriptors are kept in a contiguous `pollfd` array that is handed
+ * to the kernel as is; adding and removing descriptors takes constant
+ * time, though removal does not preserve the order of the array.
+ *
+ * This is a lighter-weight alternative to `posix::reactor` for small and
+ * frequently changing sets of descriptors, as it involves no kernel-side
+ * registration.
+ *
+ * @see http://pubs.opengroup.org/onlinepubs/9699919799/functions/poll.html
+ */
+class posix::poll_set {
+public:
+  /**
+   * Default constructor.
+   */
+  poll_set() = default;
+
+  /**
+   * Returns the number of descriptors in this set.
+   */
+  std::size_t size() const noexcept {
+    return _fds.size();
+  }
+
+  /**
+   * Checks whether this set is empty.
+   */
+  bool empty() const noexcept {
+    return _fds.empty();
+  }
+
+  /**
+   * Checks whether the given descriptor is in this set.
+   */
+  bool contains(const descriptor& descriptor) const noexcept {
+    return _index.count(descriptor.fd()) != 0;
+  }
+
+  /**
+   * Returns the underlying `pollfd` array.
+   */
+  const std::vector<struct pollfd>& fds() const noexcept {
+    return _fds;
+  }
+
+  /**
+   * Returns the descriptors found ready by the last call to `wait()`,
+   * along with their returned events in `revents`.
+   */
+  const std::vector<struct pollfd>& ready() const noexcept {
+    return _ready;
+  }
+
+  /**
+   * Adds a descriptor with the given `POLL*` events of interest, or
+   * changes the events of interest if it is already in this set.
+   */
+  void add(const descriptor& descriptor, short events);
+
+  /**
+   * Removes a descriptor from this set.
+   *
+   * @note This method is idempotent.
+   */
+  void remove(const descriptor& descriptor) noexcept;
+
+  /**
+   * Removes all descriptors from this set.
+   */
+  void clear() noexcept;
+
+  /**
+   * Waits for any of the descriptors in this set to become ready.
+   *
+   * Retries the operation automatically in case an `EINTR` (interrupted
+   * system call) error is encountered.
+   *
+   * @param timeout the timeout in milliseconds, or -1 to wait indefinitely
+   * @return the number of ready descriptors, or zero on timeout
+   * @throws posix::error on failure
+   */
+  std::size_t wait(int timeout = -1);
+
+  /**
+   * Waits for any of the descriptors in this set to become ready, with a
+   * nanosecond-resolution timeout, atomically replacing the signal mask
+   * for the duration of the call.
+   *
+   * If `sigmask` is null, retries the operation automatically in case an
+   * `EINTR` (interrupted system call) error is encountered; otherwise, a
+   * caught signal makes this method return zero.
+   *
+   * @param timeout the timeout, or `nullptr` to wait indefinitely
+   * @param sigmask the signal mask to use while waiting, or `nullptr` to
+   *                keep the current one
+   * @return the number of ready descriptors, or zero on timeout
+   * @throws posix::error on failure, e.g. `ENOSYS` when given a signal
+   *         mask on platforms without `ppoll()`
+   */
+  std::size_t wait(const struct timespec* timeout,
+                   const sigset_t* sigmask = nullptr);
+
+protected:
+  std::size_t collect(int count);
+
+  std::vector<struct pollfd> _fds;
+  std::vector<struct pollfd> _ready;
+  std::unordered_map<int, std::size_t> _index;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif /* POSIXXX_POLL_SET_H */
@@ -0,0 +1,183 @@
+/* This is free and unencumbered software released into the public domain. */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "reactor.h"
+
+#include "error.h"
+
+#include <cassert>     /* for assert() */
+#include <cerrno>      /* for errno */
+#include <fcntl.h>     /* for F_GETFD, fcntl() */
+#include <utility>     /* for std::move() */
+
+#ifdef __linux__
+#include <sys/epoll.h> /* for EPOLL*, epoll_*() */
+#else
+struct epoll_event {};
+#endif
+
+using namespace posix;
+
+constexpr std::size_t reactor::default_batch_size;
+
+#ifndef NDEBUG
+namespace {
+  bool
+  is_open(const int fd) noexcept {
+    return ::fcntl(fd, F_GETFD) != -1 || errno != EBADF;
+  }
+}
+#endif
+
+reactor::reactor(const std::size_t batch_size)
+  : _batch_size{batch_size ? batch_size : default_batch_size} {
+#ifdef __linux__
+  int epfd;
+  if ((epfd = ::epoll_create1(EPOLL_CLOEXEC)) == -1) {
+    throw_error("epoll_create1", "0x%x", static_cast<unsigned int>(EPOLL_CLOEXEC));
+  }
+  _epoll.assign(epfd);
+  _events.reset(new struct epoll_event[_batch_size]);
+#else
+  throw_error(ENOSYS); /* Function not implemented */
+#endif /* __linux__ */
+}
+
+reactor::~reactor() noexcept = default;
+
+void
+reactor::add(const descriptor& descriptor,
+             const unsigned int events,
+             callback callback) {
+  assert(callback != nullptr);
+
+#ifdef __linux__
+  std::unique_ptr<handler> entry{new handler{descriptor.fd(), std::move(callback)}};
+
+  struct epoll_event event;
+  event.events = events;
+  event.data.ptr = entry.get();
+  if (::epoll_ctl(_epoll.fd(), EPOLL_CTL_ADD, descriptor.fd(), &event) == -1) {
+    throw_error("epoll_ctl", "%d, %s, %d, {0x%x}",
+      _epoll.fd(), "EPOLL_CTL_ADD", descriptor.fd(), events);
+  }
+
+  /* The kernel accepted the descriptor, so any handler registered for the
+   * same number belongs to a descriptor closed without remove(): */
+  auto& slot = _handlers[descriptor.fd()];
+  if (slot) {
+    slot->fd = -1;
+    _retired.push_back(std::move(slot));
+  }
+  slot = std::move(entry);
+#else
+  (void)descriptor, (void)events;
+  throw_error(ENOSYS); /* Function not implemented */
+#endif /* __linux__ */
+}
+
+void
+reactor::modify(const descriptor& descriptor,
+                const unsigned int events) {
+#ifdef __linux__
+  const auto found = _handlers.find(descriptor.fd());
+  if (found == _handlers.end()) {
+    throw_error(ENOENT, "epoll_ctl", "%d, %s, %d, {0x%x}",
+      _epoll.fd(), "EPOLL_CTL_MOD", descriptor.fd(), events);
+  }
+
+  struct epoll_event event;
+  event.events = events;
+  event.data.ptr = found->second.get();
+  if (::epoll_ctl(_epoll.fd(), EPOLL_CTL_MOD, descriptor.fd(), &event) == -1) {
+    throw_error("epoll_ctl", "%d, %s, %d, {0x%x}",
+      _epoll.fd(), "EPOLL_CTL_MOD", descriptor.fd(), events);
+  }
+#else
+  (void)descriptor, (void)events;
+  throw_error(ENOSYS); /* Function not implemented */
+#endif /* __linux__ */
+}
+
+void
+reactor::remove(const descriptor& descriptor) {
+#ifdef __linux__
+  const auto found = _handlers.find(descriptor.fd());
+  if (found == _handlers.end()) {
+    return; /* not registered */
+  }
+
+  if (::epoll_ctl(_epoll.fd(), EPOLL_CTL_DEL, descriptor.fd(), nullptr) == -1) {
+    switch (errno) {
+      case EBADF:  /* Bad file descriptor; already closed */
+      case ENOENT: /* No such file or directory */
+        break;
+      default:
+        throw_error("epoll_ctl", "%d, %s, %d, %s",
+          _epoll.fd(), "EPOLL_CTL_DEL", descriptor.fd(), "NULL");
+    }
+  }
+
+  /* Events for this handler may still be pending in the current batch,
+   * so defer its destruction until the batch has been dispatched: */
+  found->second->fd = -1;
+  _retired.push_back(std::move(found->second));
+  _handlers.erase(found);
+#else
+  (void)descriptor;
+  throw_error(ENOSYS); /* Function not implemented */
+#endif /* __linux__ */
+}
+
+std::size_t
+reactor::poll(const int timeout) {
+#ifdef __linux__
+  _retired.clear();
+
+retry:
+  const int rc = ::epoll_wait(_epoll.fd(), _events.get(),
+    static_cast<int>(_batch_size), timeout);
+  if (rc == -1) {
+    switch (errno) {
+      case EINTR: /* Interrupted system call */
+        goto retry;
+      default:
+        assert(errno != EFAULT);
+        throw_error("epoll_wait", "%d, %s, %zu, %d",
+          _epoll.fd(), "events", _batch_size, timeout);
+    }
+  }
+
+  std::size_t dispatched = 0;
+  for (int i = 0; i < rc; i++) {
+    const struct epoll_event& event = _events[i];
+    handler* const entry = reinterpret_cast<handler*>(event.data.ptr);
+    if (entry->fd == -1) {
+      continue; /* removed by an earlier callback in this batch */
+    }
+    /* A descriptor closed without remove() still delivers events while a
+     * dup() keeps its open file description alive; checked per event, so
+     * that debug builds don't pay for every registered descriptor: */
+    assert(is_open(entry->fd) && "descriptor closed without remove()");
+    entry->function(entry->fd, event.events);
+    dispatched++;
+  }
+
+  _retired.clear();
+  return dispatched;
+#else
+  (void)timeout;
+  throw_error(ENOSYS); /* Function not implemented */
+#endif /* __linux__ */
+}
+
+void
+reactor::run() {
+  _stopped = false;
+  while (!_stopped && !_handlers.empty()) {
+    poll(-1);
+  }
+}
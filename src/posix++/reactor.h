@@ -0,0 +1,179 @@
+/* This is free and unencumbered software released into the public domain. */
+
+#ifndef POSIXXX_REACTOR_H
+#define POSIXXX_REACTOR_H
+
+#ifndef __cplusplus
+#error "<posix++/reactor.h> requires a C++ compiler"
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include "descriptor.h"
+
+#include <cstddef>       /* for std::size_t */
+#include <functional>    /* for std::function */
+#include <memory>        /* for std::unique_ptr */
+#include <unordered_map> /* for std::unordered_map */
+#include <vector>        /* for std::vector */
+
+struct epoll_event; // @see <sys/epoll.h>
+
+namespace posix {
+  class reactor;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * An event loop dispatching descriptor readiness events to callbacks.
+ *
+ * Any pollable descriptor may be registered, including sockets, pipes,
+ * message queues, and Linux `eventfd`/`timerfd` descriptors. Interest is
+ * given as a mask of `EPOLL*` flags from `<sys/epoll.h>`, such as
+ * `EPOLLIN`, `EPOLLOUT`, `EPOLLET` (edge-triggered), `EPOLLONESHOT`,
+ * and `EPOLLEXCLUSIVE`.
+ *
+ * Callbacks may register, modify, and remove descriptors, including the
+ * one being dispatched, while events are being dispatched.
+ *
+ * Descriptors must be removed before they are closed: the kernel drops a
+ * closed descriptor from the epoll set silently, so its handler would
+ * otherwise linger, keeping `run()` from ever returning.
+ *
+ * @note This class is Linux-specific. On other platforms, the constructor
+ *       throws a `posix::logic_error` with `ENOSYS`.
+ * @note Instances of this class are neither copyable nor movable.
+ * @see http://man7.org/linux/man-pages/man7/epoll.7.html
+ */
+class posix::reactor {
+public:
+  /**
+   * The type of event callbacks, which are given the native integer
+   * descriptor and the mask of `EPOLL*` events that occurred.
+   */
+  using callback = std::function<void (int fd, unsigned int events)>;
+
+  /**
+   * The default maximum number of events per `epoll_wait()` call.
+   */
+  static constexpr std::size_t default_batch_size = 64;
+
+  /**
+   * Constructor.
+   *
+   * @param batch_size the maximum number of events dispatched per
+   *                   `epoll_wait()` call
+   * @throws posix::error on failure
+   */
+  explicit reactor(std::size_t batch_size = default_batch_size);
+
+  /**
+   * Copy constructor.
+   */
+  reactor(const reactor& other) = delete;
+
+  /**
+   * Copy assignment operator.
+   */
+  reactor& operator=(const reactor& other) = delete;
+
+  /**
+   * Destructor.
+   */
+  ~reactor() noexcept;
+
+  /**
+   * Returns the underlying epoll descriptor.
+   */
+  const descriptor& epoll() const noexcept {
+    return _epoll;
+  }
+
+  /**
+   * Returns the number of registered descriptors.
+   */
+  std::size_t size() const noexcept {
+    return _handlers.size();
+  }
+
+  /**
+   * Checks whether the given descriptor is registered.
+   */
+  bool contains(const descriptor& descriptor) const noexcept {
+    return _handlers.count(descriptor.fd()) != 0;
+  }
+
+  /**
+   * Registers a descriptor with the given interest and callback.
+   *
+   * Should a handler linger for the same descriptor number, because its
+   * previous descriptor was closed without `remove()`, it is discarded.
+   *
+   * @throws posix::error on failure, e.g. `EEXIST` if the descriptor is
+   *         already registered
+   */
+  void add(const descriptor& descriptor, unsigned int events, callback callback);
+
+  /**
+   * Changes the interest for a registered descriptor. This also rearms a
+   * descriptor registered with `EPOLLONESHOT`.
+   *
+   * @throws posix::error on failure, e.g. `EINVAL` if the descriptor was
+   *         registered with `EPOLLEXCLUSIVE`
+   */
+  void modify(const descriptor& descriptor, unsigned int events);
+
+  /**
+   * Unregisters a descriptor.
+   *
+   * @pre The descriptor must not yet have been closed.
+   * @note This method is idempotent.
+   */
+  void remove(const descriptor& descriptor);
+
+  /**
+   * Waits for events and dispatches a batch of them to their callbacks.
+   *
+   * Retries the operation automatically in case an `EINTR` (interrupted
+   * system call) error is encountered.
+   *
+   * @param timeout the timeout in milliseconds, or -1 to wait indefinitely
+   * @return the number of events dispatched, or zero on timeout
+   * @pre No registered descriptor may have been closed without `remove()`.
+   * @throws posix::error on failure
+   */
+  std::size_t poll(int timeout = -1);
+
+  /**
+   * Dispatches events until `stop()` is called or no descriptors remain
+   * registered.
+   *
+   * @pre No registered descriptor may have been closed without `remove()`.
+   */
+  void run();
+
+  /**
+   * Makes `run()` return after dispatching the current batch of events.
+   */
+  void stop() noexcept {
+    _stopped = true;
+  }
+
+protected:
+  struct handler {
+    int fd;
+    callback function;
+  };
+
+  descriptor _epoll;
+  std::size_t _batch_size;
+  std::unique_ptr<struct epoll_event[]> _events;
+  std::unordered_map<int, std::unique_ptr<handler>> _handlers;
+  std::vector<std::unique_ptr<handler>> _retired;
+  bool _stopped = false;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif /* POSIXXX_REACTOR_H */
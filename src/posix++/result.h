@@ -0,0 +1,251 @@
+/* This is free and unencumbered software released into the public domain. */
+
+#ifndef POSIXXX_RESULT_H
+#define POSIXXX_RESULT_H
+
+#ifndef __cplusplus
+#error "<posix++/result.h> requires a C++ compiler"
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include "error.h"
+
+#include <cassert>      /* for assert() */
+#include <cerrno>       /* for errno */
+#include <new>          /* for placement new */
+#include <system_error> /* for std::error_code, std::generic_category() */
+#include <utility>      /* for std::move() */
+
+namespace posix {
+  template<typename T> class result;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Holds either the value returned by an operation, or the error code it
+ * failed with.
+ *
+ * This is what the non-throwing `try_*()` operations return. Constructing
+ * a failed result neither allocates memory nor formats a message, making
+ * it suitable for expected errors on hot paths, such as `EAGAIN` on
+ * non-blocking descriptors.
+ */
+template<typename T>
+class posix::result {
+public:
+  using value_type = T;
+
+  /**
+   * Returns a failed result holding the current value of `errno`.
+   */
+  static result from_errno() noexcept {
+    return result{std::error_code{errno, std::generic_category()}};
+  }
+
+  /**
+   * Constructor for a successful result.
+   */
+  result(const T& value)
+    : _ok{true} {
+    new (&_value) T(value);
+  }
+
+  /**
+   * Constructor for a successful result.
+   */
+  result(T&& value) noexcept
+    : _ok{true} {
+    new (&_value) T(std::move(value));
+  }
+
+  /**
+   * Constructor for a failed result.
+   */
+  result(const std::error_code error) noexcept
+    : _error{error} {
+    assert(error);
+  }
+
+  /**
+   * Copy constructor.
+   */
+  result(const result& other)
+    : _ok{other._ok}, _error{other._error} {
+    if (_ok) new (&_value) T(other._value);
+  }
+
+  /**
+   * Move constructor.
+   */
+  result(result&& other) noexcept
+    : _ok{other._ok}, _error{other._error} {
+    if (_ok) new (&_value) T(std::move(other._value));
+  }
+
+  /**
+   * Copy assignment operator.
+   */
+  result& operator=(const result& other) {
+    if (this != &other) {
+      reset();
+      _error = other._error;
+      if (other._ok) new (&_value) T(other._value);
+      _ok = other._ok;
+    }
+    return *this;
+  }
+
+  /**
+   * Move assignment operator.
+   */
+  result& operator=(result&& other) noexcept {
+    if (this != &other) {
+      reset();
+      _error = other._error;
+      if (other._ok) new (&_value) T(std::move(other._value));
+      _ok = other._ok;
+    }
+    return *this;
+  }
+
+  /**
+   * Destructor.
+   */
+  ~result() noexcept {
+    reset();
+  }
+
+  /**
+   * Checks whether this result holds a value.
+   */
+  bool ok() const noexcept {
+    return _ok;
+  }
+
+  /**
+   * Checks whether this result holds a value.
+   */
+  explicit operator bool() const noexcept {
+    return _ok;
+  }
+
+  /**
+   * Returns the error code, which is empty for a successful result.
+   */
+  std::error_code error() const noexcept {
+    return _error;
+  }
+
+  /**
+   * Checks whether this result failed with the given error number.
+   */
+  bool is(const int code) const noexcept {
+    return !_ok && _error.value() == code &&
+      _error.category() == std::generic_category();
+  }
+
+  /**
+   * Checks whether this result failed because the operation would have
+   * blocked, i.e., with `EAGAIN` or `EWOULDBLOCK`.
+   */
+  bool would_block() const noexcept {
+    return is(EAGAIN) || is(EWOULDBLOCK);
+  }
+
+  /**
+   * Returns the value.
+   *
+   * @throws posix::error if this result holds an error
+   */
+  T& value() & {
+    if (!_ok) throw_error(_error.value());
+    return _value;
+  }
+
+  /**
+   * Returns the value.
+   *
+   * @throws posix::error if this result holds an error
+   */
+  const T& value() const& {
+    if (!_ok) throw_error(_error.value());
+    return _value;
+  }
+
+  /**
+   * Moves out the value.
+   *
+   * @throws posix::error if this result holds an error
+   */
+  T&& value() && {
+    if (!_ok) throw_error(_error.value());
+    return std::move(_value);
+  }
+
+  /**
+   * Returns the value, or the given fallback for a failed result.
+   */
+  T value_or(T fallback) const& {
+    return _ok ? _value : std::move(fallback);
+  }
+
+  /**
+   * Returns the value.
+   *
+   * @pre `ok()` is `true`
+   */
+  T& operator*() noexcept {
+    assert(_ok);
+    return _value;
+  }
+
+  /**
+   * Returns the value.
+   *
+   * @pre `ok()` is `true`
+   */
+  const T& operator*() const noexcept {
+    assert(_ok);
+    return _value;
+  }
+
+  /**
+   * Accesses the value.
+   *
+   * @pre `ok()` is `true`
+   */
+  T* operator->() noexcept {
+    assert(_ok);
+    return &_value;
+  }
+
+  /**
+   * Accesses the value.
+   *
+   * @pre `ok()` is `true`
+   */
+  const T* operator->() const noexcept {
+    assert(_ok);
+    return &_value;
+  }
+
+protected:
+  void reset() noexcept {
+    if (_ok) {
+      _value.~T();
+      _ok = false;
+    }
+  }
+
+  bool _ok = false;
+  std::error_code _error;
+  union {
+    T _value;
+  };
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif /* POSIXXX_RESULT_H */
@@ -0,0 +1,148 @@
+/* This is free and unencumbered software released into the public domain. */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "ring_buffer.h"
+
+#include "descriptor.h"
+#include "error.h"
+#include "result.h"
+
+#ifndef DISABLE_SOCKET
+#include "socket.h"
+#endif
+
+#include <algorithm>  /* for std::max() */
+#include <cerrno>     /* for ENOSYS */
+#include <cstdlib>    /* for mkstemp() */
+#include <sys/mman.h> /* for memfd_create(), MAP_*, PROT_* */
+#include <unistd.h>   /* for _SC_PAGE_SIZE, ftruncate(), sysconf(), unlink() */
+#include <utility>    /* for std::swap() */
+
+#ifndef MAP_NORESERVE
+#define MAP_NORESERVE 0 /* not supported by all platforms */
+#endif
+
+using namespace posix;
+
+namespace {
+  std::size_t
+  round_up_to_page(const std::size_t size) noexcept {
+    const auto page_size = static_cast<std::size_t>(::sysconf(_SC_PAGE_SIZE));
+    return std::max(page_size, (size + page_size - 1) / page_size * page_size);
+  }
+
+  descriptor
+  create_backing_file(const std::size_t size) {
+#ifdef HAVE_MEMFD_CREATE
+    descriptor result{::memfd_create("posix::ring_buffer", MFD_CLOEXEC)};
+    if (!result.valid()) {
+      throw_error("memfd_create", "%s, %s", "\"posix::ring_buffer\"", "MFD_CLOEXEC");
+    }
+#else
+    char pathname[] = "/tmp/posix++.ring_buffer.XXXXXX";
+    descriptor result{::mkstemp(pathname)};
+    if (!result.valid()) {
+      throw_error("mkstemp", "%s", pathname);
+    }
+    ::unlink(pathname);
+#endif
+    if (::ftruncate(result.fd(), static_cast<off_t>(size)) == -1) {
+      throw_error("ftruncate", "%d, %zu", result.fd(), size);
+    }
+    return result;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+ring_buffer::ring_buffer(const std::size_t capacity)
+  : _mapping{nullptr, 0},
+    _capacity{round_up_to_page(capacity)},
+    _head{0},
+    _tail{0} {
+
+  const descriptor file = create_backing_file(_capacity);
+
+  /* Reserve twice the capacity, then map the file over each half: */
+  memory_mapping region = memory_mapping::anonymous(2 * _capacity,
+    PROT_NONE, MAP_PRIVATE | MAP_NORESERVE);
+  for (std::size_t offset = 0; offset < 2 * _capacity; offset += _capacity) {
+    memory_mapping{file, _capacity, 0, PROT_READ | PROT_WRITE,
+      MAP_SHARED | MAP_FIXED, region.data(offset)}.release();
+  }
+
+  _mapping = memory_mapping{region.release(), 2 * _capacity,
+    PROT_READ | PROT_WRITE, MAP_SHARED};
+}
+
+ring_buffer::ring_buffer(ring_buffer&& other) noexcept
+  : _mapping{std::move(other._mapping)},
+    _capacity{other._capacity},
+    _head{other._head},
+    _tail{other._tail} {
+  other._capacity = other._head = other._tail = 0;
+}
+
+ring_buffer&
+ring_buffer::operator=(ring_buffer&& other) noexcept {
+  if (this != &other) {
+    std::swap(_mapping, other._mapping);
+    std::swap(_capacity, other._capacity);
+    std::swap(_head, other._head);
+    std::swap(_tail, other._tail);
+  }
+  return *this;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+std::size_t
+ring_buffer::read_from(const descriptor& descriptor) {
+  if (full()) {
+    return 0;
+  }
+  const auto result = descriptor.try_read(tail(), available());
+  if (!result) {
+    throw_error(result.error().value(), "read", "%d, %s, %zu",
+      descriptor.fd(), "tail", available());
+  }
+  commit(*result);
+  return *result;
+}
+
+std::size_t
+ring_buffer::recv_from(socket& socket,
+                       const int flags) {
+#ifndef DISABLE_SOCKET
+  if (full()) {
+    return 0;
+  }
+  const auto result = socket.try_recv(tail(), available(), flags);
+  if (!result) {
+    throw_error(result.error().value(), "recv", "%d, %s, %zu, 0x%x",
+      socket.fd(), "tail", available(), static_cast<unsigned int>(flags));
+  }
+  commit(*result);
+  return *result;
+#else
+  (void)socket, (void)flags;
+  throw_error(ENOSYS); /* Function not implemented */
+#endif /* DISABLE_SOCKET */
+}
+
+std::size_t
+ring_buffer::write_to(descriptor& descriptor) {
+  if (empty()) {
+    return 0;
+  }
+  const auto result = descriptor.try_write(data(), size());
+  if (!result) {
+    throw_error(result.error().value(), "write", "%d, %s, %zu",
+      descriptor.fd(), "data", size());
+  }
+  consume(*result);
+  return *result;
+}
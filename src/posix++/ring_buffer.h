@@ -0,0 +1,187 @@
+/* This is free and unencumbered software released into the public domain. */
+
+#ifndef POSIXXX_RING_BUFFER_H
+#define POSIXXX_RING_BUFFER_H
+
+#ifndef __cplusplus
+#error "<posix++/ring_buffer.h> requires a C++ compiler"
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include "memory_mapping.h"
+
+#include <cassert> /* for assert() */
+#include <cstddef> /* for std::size_t */
+#include <cstdint> /* for std::uint8_t */
+
+namespace posix {
+  struct descriptor;
+  class ring_buffer;
+  class socket;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * A circular byte buffer whose contents are always contiguous in memory.
+ *
+ * The buffer's memory is mapped twice, back to back, so that any data or
+ * free space that wraps around the end of the buffer can nonetheless be
+ * accessed through a single pointer. This lets data be received directly
+ * into the buffer and parsed in place, without ever copying it to undo
+ * the wraparound.
+ *
+ * Data is produced by writing at `tail()` and then calling `commit()`,
+ * and consumed by reading from `data()` and then calling `consume()`.
+ *
+ * @note The capacity is rounded up to a multiple of the page size.
+ */
+class posix::ring_buffer {
+protected:
+  memory_mapping _mapping;
+  std::size_t _capacity;
+  std::size_t _head;
+  std::size_t _tail;
+
+public:
+  /**
+   * Constructor.
+   *
+   * @param capacity the minimum capacity in bytes
+   * @throws posix::error on failure
+   */
+  explicit ring_buffer(std::size_t capacity);
+
+  /**
+   * Move constructor.
+   */
+  ring_buffer(ring_buffer&& other) noexcept;
+
+  /**
+   * Move assignment operator.
+   */
+  ring_buffer& operator=(ring_buffer&& other) noexcept;
+
+  /**
+   * Returns the capacity in bytes.
+   */
+  std::size_t capacity() const noexcept {
+    return _capacity;
+  }
+
+  /**
+   * Returns the number of bytes that can be consumed.
+   */
+  std::size_t size() const noexcept {
+    return _tail - _head;
+  }
+
+  /**
+   * Returns the number of bytes that can be committed.
+   */
+  std::size_t available() const noexcept {
+    return _capacity - size();
+  }
+
+  /**
+   * Checks whether this buffer holds no data.
+   */
+  bool empty() const noexcept {
+    return _tail == _head;
+  }
+
+  /**
+   * Checks whether this buffer has no free space.
+   */
+  bool full() const noexcept {
+    return size() == _capacity;
+  }
+
+  /**
+   * Returns a pointer to the `size()` contiguous bytes of data.
+   */
+  std::uint8_t* data() noexcept {
+    return _mapping.data(_head);
+  }
+
+  /**
+   * Returns a pointer to the `size()` contiguous bytes of data.
+   */
+  const std::uint8_t* data() const noexcept {
+    return _mapping.data(_head);
+  }
+
+  /**
+   * Returns a pointer to the `available()` contiguous bytes of free space.
+   */
+  std::uint8_t* tail() noexcept {
+    return _mapping.data(_tail);
+  }
+
+  /**
+   * Marks bytes written at `tail()` as data.
+   *
+   * @pre `count <= available()`
+   */
+  void commit(const std::size_t count) noexcept {
+    assert(count <= available());
+    _tail += count;
+  }
+
+  /**
+   * Discards bytes of data from `data()`.
+   *
+   * @pre `count <= size()`
+   */
+  void consume(const std::size_t count) noexcept {
+    assert(count <= size());
+    _head += count;
+    if (_head >= _capacity) {
+      _head -= _capacity;
+      _tail -= _capacity;
+    }
+  }
+
+  /**
+   * Discards all data.
+   */
+  void clear() noexcept {
+    _head = _tail = 0;
+  }
+
+  /**
+   * Reads data from the given descriptor into the free space, with a
+   * single `read()` call, and commits it.
+   *
+   * @return the number of bytes read, or zero on EOF or if the buffer is
+   *         full
+   * @throws posix::error on failure, including `EAGAIN` for non-blocking
+   *         descriptors with no data
+   */
+  std::size_t read_from(const descriptor& descriptor);
+
+  /**
+   * Receives data from the given socket into the free space, with a
+   * single `recv()` call, and commits it.
+   *
+   * @return the number of bytes received, or zero on an orderly shutdown
+   *         or if the buffer is full
+   * @throws posix::error on failure, including `EAGAIN` for non-blocking
+   *         sockets with no data
+   */
+  std::size_t recv_from(socket& socket, int flags = 0);
+
+  /**
+   * Writes data to the given descriptor, with a single `write()` call,
+   * and consumes it.
+   *
+   * @return the number of bytes written
+   * @throws posix::error on failure
+   */
+  std::size_t write_to(descriptor& descriptor);
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif /* POSIXXX_RING_BUFFER_H */
@@ -0,0 +1,70 @@
+/* This is free and unencumbered software released into the public domain. */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "shared_buffer.h"
+
+#include "error.h"
+
+#include <cassert>    /* for assert() */
+#include <cerrno>     /* for ENOSYS */
+#include <fcntl.h>    /* for F_ADD_SEALS, F_GET_SEALS */
+#include <sys/mman.h> /* for memfd_create(), MFD_*, MAP_SHARED */
+
+using namespace posix;
+
+shared_buffer
+shared_buffer::create(std::size_t size,
+                      const unsigned int flags,
+                      const char* const name) {
+  assert(name != nullptr);
+
+#if defined(HAVE_MEMFD_CREATE) && defined(F_ADD_SEALS)
+#ifdef MFD_HUGETLB
+  if (flags & MFD_HUGETLB) {
+    const std::size_t page_size = memory_mapping::huge_page_size();
+    if (page_size) {
+      size = (size + page_size - 1) / page_size * page_size;
+    }
+  }
+#endif
+
+  shared_buffer result{::memfd_create(name, flags | MFD_CLOEXEC | MFD_ALLOW_SEALING)};
+  if (!result.valid()) {
+    throw_error("memfd_create", "\"%s\", 0x%x", name, flags | MFD_CLOEXEC | MFD_ALLOW_SEALING);
+  }
+  if (size) {
+    result.truncate(static_cast<off_t>(size));
+  }
+  return result;
+#else
+  (void)size, (void)flags;
+  throw_error(ENOSYS); /* Function not implemented */
+#endif
+}
+
+int
+shared_buffer::seals() const {
+#ifdef F_GET_SEALS
+  return fcntl(F_GET_SEALS);
+#else
+  throw_error(ENOSYS); /* Function not implemented */
+#endif
+}
+
+void
+shared_buffer::seal(const int seals) {
+#ifdef F_ADD_SEALS
+  fcntl(F_ADD_SEALS, seals);
+#else
+  (void)seals;
+  throw_error(ENOSYS); /* Function not implemented */
+#endif
+}
+
+memory_mapping
+shared_buffer::map(const int prot) const {
+  return memory_mapping{*this, size(), 0, prot, MAP_SHARED};
+}
@@ -0,0 +1,136 @@
+/* This is free and unencumbered software released into the public domain. */
+
+#ifndef POSIXXX_SHARED_BUFFER_H
+#define POSIXXX_SHARED_BUFFER_H
+
+#ifndef __cplusplus
+#error "<posix++/shared_buffer.h> requires a C++ compiler"
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include "file.h"
+#include "memory_mapping.h"
+
+#include <cstddef> /* for std::size_t */
+#include <fcntl.h> /* for F_SEAL_* */
+#include <utility> /* for std::move(), std::swap() */
+
+#if defined(F_ADD_SEALS) && !defined(F_SEAL_FUTURE_WRITE)
+#define F_SEAL_FUTURE_WRITE 0x0010 /* Linux 5.1+ */
+#endif
+
+namespace posix {
+  class shared_buffer;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * An anonymous, memory-backed file for handing bulk data between
+ * processes without copying it.
+ *
+ * The buffer is created with `memfd_create()`, filled through a writable
+ * mapping, sealed, and then passed to another process with
+ * `local_socket::send_descriptor()`. The receiving process wraps the
+ * descriptor, checks the seals with `sealed()` so that it need not trust
+ * the sender not to change the contents or size from under it, and maps
+ * the buffer read-only.
+ *
+ * The seals are `F_SEAL_SEAL` (no further seals), `F_SEAL_SHRINK`,
+ * `F_SEAL_GROW`, `F_SEAL_WRITE` (no writes at all, which requires that
+ * no writable shared mapping exists), and `F_SEAL_FUTURE_WRITE` (no new
+ * writes, while the sender's existing mapping remains writable).
+ *
+ * @note This class is Linux-specific; elsewhere, `create()` fails with
+ *       `ENOSYS`.
+ * @see http://man7.org/linux/man-pages/man2/memfd_create.2.html
+ */
+class posix::shared_buffer : public posix::file {
+public:
+  /**
+   * Creates a new, zero-filled buffer that can be sealed.
+   *
+   * @param flags `MFD_HUGETLB` to back the buffer with huge pages, in
+   *              which case `size` is rounded up to a multiple of the huge
+   *              page size
+   * @param name the name shown in `/proc/self/fd/`, for debugging
+   * @throws posix::error on failure
+   */
+  static shared_buffer create(std::size_t size, unsigned int flags = 0,
+    const char* name = "posix::shared_buffer");
+
+  /**
+   * Default constructor.
+   */
+  shared_buffer() noexcept
+    : file{} {}
+
+  /**
+   * Constructor.
+   */
+  explicit shared_buffer(const int fd) noexcept
+    : file{fd} {}
+
+  /**
+   * Constructor. Takes ownership of a descriptor, such as one obtained
+   * from `local_socket::recv_descriptor()`.
+   */
+  explicit shared_buffer(descriptor&& descriptor) noexcept
+    : file{descriptor.release()} {}
+
+  /**
+   * Move constructor.
+   */
+  shared_buffer(shared_buffer&& other) noexcept
+    : file{std::move(other)} {}
+
+  /**
+   * Move assignment operator.
+   */
+  shared_buffer& operator=(shared_buffer&& other) noexcept {
+    std::swap(_fd, other._fd);
+    return *this;
+  }
+
+  /**
+   * Returns the `F_SEAL_*` seals currently set on this buffer.
+   *
+   * @throws posix::error on failure
+   */
+  int seals() const;
+
+  /**
+   * Checks whether all of the given `F_SEAL_*` seals are set on this
+   * buffer.
+   *
+   * @throws posix::error on failure
+   */
+  bool sealed(int seals) const {
+    return (this->seals() & seals) == seals;
+  }
+
+  /**
+   * Adds the given `F_SEAL_*` seals to this buffer. Seals cannot be
+   * removed once set.
+   *
+   * @throws posix::error on failure, e.g. `EPERM` if the buffer is sealed
+   *         with `F_SEAL_SEAL`, or `EBUSY` when adding `F_SEAL_WRITE`
+   *         while a writable shared mapping exists
+   */
+  void seal(int seals);
+
+  /**
+   * Maps this entire buffer into memory.
+   *
+   * @param prot `PROT_READ` for a read-only mapping, as befits the
+   *             receiver, or `PROT_READ | PROT_WRITE`
+   * @throws posix::error on failure, e.g. `EPERM` for a writable mapping
+   *         of a write-sealed buffer
+   */
+  memory_mapping map(int prot = PROT_READ) const;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif /* POSIXXX_SHARED_BUFFER_H */
@@ -7,16 +7,80 @@
 #include "socket.h"
 
 #include "error.h"
+#include "file.h"
+#include "iov.h"
+#include "splice.h"
 
+#include <algorithm>    /* for std::min() */
 #include <array>        /* for std::array */
 #include <cassert>      /* for assert() */
 #include <cerrno>       /* for errno */
 #include <cstdint>      /* for std::uint8_t */
-#include <cstring>      /* for std::strlen() */
-#include <sys/socket.h> /* for getsockopt(), listen(), recv(), send(), shutdown() */
+#include <cstring>      /* for std::memset(), std::strlen() */
+#include <sys/socket.h> /* for getsockopt(), listen(), recv*(), send*(), shutdown() */
+#include <sys/uio.h>    /* for struct iovec */
+#include <unistd.h>     /* for pread() */
+#include <vector>       /* for std::vector */
+
+#ifdef __linux__
+#include <sys/sendfile.h> /* for sendfile() */
+#endif
 
 using namespace posix;
 
+namespace {
+  /**
+   * Tracks the progress of a scatter/gather transfer, presenting the
+   * remainder of a partially transferred buffer as a separate segment.
+   */
+  struct iov_cursor {
+    const struct iovec* iov;
+    std::size_t iovcnt;
+    std::size_t index;
+    struct iovec head;
+
+    iov_cursor(const struct iovec* const iov, const std::size_t iovcnt)
+      : iov{iov}, iovcnt{iovcnt}, index{0}, head{nullptr, 0} {}
+
+    bool done() const noexcept {
+      return index == iovcnt;
+    }
+
+    void prepare(struct msghdr& msg) noexcept {
+      std::memset(&msg, 0, sizeof(msg));
+      if (head.iov_base) {
+        msg.msg_iov = &head;
+        msg.msg_iovlen = 1;
+      }
+      else {
+        msg.msg_iov = const_cast<struct iovec*>(iov + index);
+        msg.msg_iovlen = std::min(iovcnt - index, iov_max);
+      }
+    }
+
+    void advance(std::size_t size) noexcept {
+      if (head.iov_base) {
+        if (size < head.iov_len) {
+          head.iov_base = reinterpret_cast<std::uint8_t*>(head.iov_base) + size;
+          head.iov_len -= size;
+          return;
+        }
+        size -= head.iov_len;
+        head = {nullptr, 0};
+        index++;
+      }
+      while (index < iovcnt && size >= iov[index].iov_len) {
+        size -= iov[index].iov_len;
+        index++;
+      }
+      if (size) {
+        head.iov_base = reinterpret_cast<std::uint8_t*>(iov[index].iov_base) + size;
+        head.iov_len = iov[index].iov_len - size;
+      }
+    }
+  };
+}
+
 int
 socket::domain() const {
   int optval = 0;
@@ -107,6 +171,120 @@ socket::send(const void* const data,
   }
 }
 
+void
+socket::send(const struct iovec* const iov,
+             const std::size_t iovcnt,
+             const int flags) {
+  assert(iov != nullptr || iovcnt == 0);
+
+  iov_cursor cursor{iov, iovcnt};
+  while (!cursor.done()) {
+    struct msghdr msg;
+    cursor.prepare(msg);
+    const ssize_t rc = ::sendmsg(fd(), &msg, flags);
+    if (rc == -1) {
+      switch (errno) {
+        case EINTR:  /* Interrupted system call */
+          continue;
+        default:
+          throw_error("sendmsg", "%d, %s, 0x%x", fd(), "msg",
+            static_cast<unsigned int>(flags));
+      }
+    }
+    cursor.advance(static_cast<std::size_t>(rc));
+  }
+}
+
+result<std::size_t>
+socket::try_send(const void* const data,
+                 const std::size_t size,
+                 const int flags) noexcept {
+  assert(data != nullptr || size == 0);
+
+retry:
+  const ssize_t rc = ::send(fd(), data, size, flags);
+  if (rc == -1) {
+    switch (errno) {
+      case EINTR: /* Interrupted system call */
+        goto retry;
+      default:
+        return result<std::size_t>::from_errno();
+    }
+  }
+  return static_cast<std::size_t>(rc);
+}
+
+std::size_t
+socket::send_file(const file& file,
+                  off_t offset,
+                  const std::size_t length) {
+  std::size_t byte_count = 0;
+
+#ifdef __linux__
+  /* The maximum number of bytes per sendfile() call: */
+  static const std::size_t chunk_size_max = 1UL << 30;
+
+  while (byte_count < length) {
+    const std::size_t chunk_size = std::min(length - byte_count, chunk_size_max);
+    const ssize_t rc = ::sendfile(fd(), file.fd(), &offset, chunk_size);
+    switch (rc) {
+      case -1:
+        switch (errno) {
+          case EINTR:      /* Interrupted system call */
+            continue; /* try again */
+          case EINVAL:     /* Invalid argument */
+          case ENOSYS:     /* Function not implemented */
+          case EOPNOTSUPP: /* Operation not supported */
+            goto fallback;
+          default:
+            throw_error("sendfile", "%d, %d, 0x%lx, %zu", fd(), file.fd(),
+              static_cast<unsigned long>(offset), chunk_size);
+        }
+
+      case 0:
+        return byte_count; /* EOF */
+
+      default:
+        assert(rc > 0);
+        byte_count += static_cast<std::size_t>(rc);
+    }
+  }
+  return byte_count;
+
+fallback:
+#endif /* __linux__ */
+
+  if (splice_through_pipe(file, &offset, *this, length - byte_count, byte_count)) {
+    return byte_count;
+  }
+
+  std::vector<std::uint8_t> buffer(65536);
+  while (byte_count < length) {
+    const std::size_t chunk_size = std::min(length - byte_count, buffer.size());
+    const ssize_t rc = ::pread(file.fd(), buffer.data(), chunk_size, offset);
+    switch (rc) {
+      case -1:
+        switch (errno) {
+          case EINTR: /* Interrupted system call */
+            continue; /* try again */
+          default:
+            throw_error("pread", "%d, %s, %zu, 0x%lx", file.fd(), "buffer",
+              chunk_size, static_cast<unsigned long>(offset));
+        }
+
+      case 0:
+        return byte_count; /* EOF */
+
+      default:
+        assert(rc > 0);
+        send(buffer.data(), static_cast<std::size_t>(rc));
+        offset += rc;
+        byte_count += static_cast<std::size_t>(rc);
+    }
+  }
+  return byte_count;
+}
+
 std::string
 socket::recv_chunk() {
   std::string buffer;
@@ -203,6 +381,63 @@ exit:
   return byte_count;
 }
 
+std::size_t
+socket::recv(const struct iovec* const iov,
+             const std::size_t iovcnt,
+             const int flags) {
+  assert(iov != nullptr || iovcnt == 0);
+
+  std::size_t byte_count = 0;
+
+  iov_cursor cursor{iov, iovcnt};
+  while (!cursor.done()) {
+    struct msghdr msg;
+    cursor.prepare(msg);
+    const ssize_t rc = ::recvmsg(fd(), &msg, flags);
+    switch (rc) {
+      case -1:
+        switch (errno) {
+          case EINTR: /* Interrupted system call */
+            continue; /* try again */
+          default:
+            throw_error("recvmsg", "%d, %s, 0x%x", fd(), "msg",
+              static_cast<unsigned int>(flags));
+        }
+
+      case 0:
+        goto exit; /* peer has performed an orderly shutdown */
+
+      default:
+        assert(rc > 0);
+        const std::size_t chunk_size = static_cast<std::size_t>(rc);
+        byte_count += chunk_size;
+        cursor.advance(chunk_size);
+    }
+  }
+
+exit:
+  return byte_count;
+}
+
+result<std::size_t>
+socket::try_recv(void* const buffer,
+                 const std::size_t buffer_size,
+                 const int flags) noexcept {
+  assert(buffer != nullptr || buffer_size == 0);
+
+retry:
+  const ssize_t rc = ::recv(fd(), buffer, buffer_size, flags);
+  if (rc == -1) {
+    switch (errno) {
+      case EINTR: /* Interrupted system call */
+        goto retry;
+      default:
+        return result<std::size_t>::from_errno();
+    }
+  }
+  return static_cast<std::size_t>(rc);
+}
+
 void
 socket::close_write() {
   shutdown(SHUT_WR);
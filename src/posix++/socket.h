@@ -10,13 +10,16 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 #include "descriptor.h"
+#include "result.h"
 
-#include <cstddef>    /* for std::size_t */
-#include <functional> /* for std::function */
-#include <string>     /* for std::string */
-#include <utility>    /* for std::move() */
+#include <cstddef>     /* for std::size_t */
+#include <functional>  /* for std::function */
+#include <string>      /* for std::string */
+#include <sys/types.h> /* for off_t */
+#include <utility>     /* for std::move() */
 
 namespace posix {
+  class file;
   class socket;
 }
 
@@ -76,6 +79,46 @@ public:
    */
   void send(const void* data, std::size_t size);
 
+  /**
+   * Sends data from multiple buffers to the peer (gather output).
+   *
+   * Will either send all the given data, or throw an error.
+   *
+   * Resumes automatically after partial sends, including those ending in
+   * the middle of a buffer, and retries the operation in case an `EINTR`
+   * (interrupted system call) error is encountered.
+   *
+   * @see http://pubs.opengroup.org/onlinepubs/9699919799/functions/sendmsg.html
+   */
+  void send(const struct iovec* iov, std::size_t iovcnt, int flags = 0);
+
+  /**
+   * Sends data to the peer with a single `send()` call, which may send
+   * less than `size` bytes.
+   *
+   * Retries the operation automatically in case an `EINTR` (interrupted
+   * system call) error is encountered.
+   *
+   * @return the number of bytes sent, or the error code on failure (e.g.
+   *         `EAGAIN` for a non-blocking socket)
+   */
+  result<std::size_t> try_send(const void* data, std::size_t size, int flags = 0) noexcept;
+
+  /**
+   * Sends the contents of a file to the peer, starting at the given file
+   * offset, until EOF or until `length` bytes have been sent.
+   *
+   * Uses `sendfile()` to avoid copying the data through user space, and
+   * falls back to `splice()` and then to `pread()`/`send()` where that is
+   * not supported. The file offset of the file is left unchanged.
+   *
+   * @return the number of bytes sent
+   * @throws posix::error on failure
+   * @see http://man7.org/linux/man-pages/man2/sendfile.2.html
+   */
+  std::size_t send_file(const file& file, off_t offset = 0,
+    std::size_t length = static_cast<std::size_t>(-1));
+
   /**
    * Receives a text chunk from the peer.
    */
@@ -101,6 +144,29 @@ public:
    */
   std::size_t recv(void* buffer, std::size_t buffer_size, int flags = 0);
 
+  /**
+   * Receives data from the peer into multiple buffers (scatter input).
+   *
+   * Will either fill all the given buffers, or stop short when the peer
+   * has performed an orderly shutdown.
+   *
+   * @see http://pubs.opengroup.org/onlinepubs/9699919799/functions/recvmsg.html
+   */
+  std::size_t recv(const struct iovec* iov, std::size_t iovcnt, int flags = 0);
+
+  /**
+   * Receives data from the peer with a single `recv()` call, which may
+   * receive less than `buffer_size` bytes.
+   *
+   * Retries the operation automatically in case an `EINTR` (interrupted
+   * system call) error is encountered.
+   *
+   * @return the number of bytes received, zero if the peer has performed
+   *         an orderly shutdown, or the error code on failure (e.g.
+   *         `EAGAIN` for a non-blocking socket)
+   */
+  result<std::size_t> try_recv(void* buffer, std::size_t buffer_size, int flags = 0) noexcept;
+
   /**
    * Closes this socket for writing.
    */
@@ -0,0 +1,155 @@
+/* This is free and unencumbered software released into the public domain. */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "splice.h"
+
+#include "descriptor.h"
+#include "error.h"
+
+#include <algorithm> /* for std::min() */
+#include <cassert>   /* for assert() */
+#include <cerrno>    /* for errno */
+#include <cstdint>   /* for std::uint8_t */
+#include <fcntl.h>   /* for O_CLOEXEC, SPLICE_F_*, splice(), tee(), vmsplice() */
+#include <sys/uio.h> /* for struct iovec */
+#include <unistd.h>  /* for pipe2() */
+#include <vector>    /* for std::vector */
+
+using namespace posix;
+
+std::size_t
+posix::splice(const descriptor& from,
+              const descriptor& to,
+              const std::size_t length,
+              const unsigned int flags) {
+  return splice(from, nullptr, to, nullptr, length, flags);
+}
+
+std::size_t
+posix::splice(const descriptor& from,
+              off_t* const from_offset,
+              const descriptor& to,
+              off_t* const to_offset,
+              const std::size_t length,
+              const unsigned int flags) {
+#ifdef __linux__
+retry:
+  const ssize_t rc = ::splice(from.fd(), from_offset, to.fd(), to_offset, length, flags);
+  if (rc == -1) {
+    switch (errno) {
+      case EINTR: /* Interrupted system call */
+        goto retry;
+      default:
+        throw_error("splice", "%d, %p, %d, %p, %zu, 0x%x",
+          from.fd(), from_offset, to.fd(), to_offset, length, flags);
+    }
+  }
+  return static_cast<std::size_t>(rc);
+#else
+  (void)from, (void)from_offset, (void)to, (void)to_offset, (void)length, (void)flags;
+  throw_error(ENOSYS); /* Function not implemented */
+#endif /* __linux__ */
+}
+
+bool
+posix::splice_through_pipe(const descriptor& from,
+                           off_t* const from_offset,
+                           descriptor& to,
+                           const std::size_t length,
+                           std::size_t& byte_count) {
+#ifdef __linux__
+  /* The maximum number of bytes per iteration: */
+  static const std::size_t chunk_size_max = 65536;
+
+  int fds[2];
+  if (::pipe2(fds, O_CLOEXEC) == -1) {
+    throw_error("pipe2", "%s, 0x%x", "pipefd", static_cast<unsigned int>(O_CLOEXEC));
+  }
+  const descriptor pipe_output{fds[0]}, pipe_input{fds[1]};
+
+  std::size_t moved = 0;
+  std::size_t pending = 0; /* bytes in the intermediate pipe */
+  try {
+    while (moved < length) {
+      pending = splice(from, from_offset, pipe_input, nullptr,
+        std::min(length - moved, chunk_size_max), SPLICE_F_MOVE | SPLICE_F_MORE);
+      if (!pending) {
+        break; /* EOF */
+      }
+      while (pending) {
+        const std::size_t chunk_size =
+          splice(pipe_output, nullptr, to, nullptr, pending, SPLICE_F_MOVE);
+        pending -= chunk_size;
+        moved += chunk_size;
+        byte_count += chunk_size;
+      }
+    }
+    return true;
+  }
+  catch (const posix::logic_error& error) {
+    if (error.number() != EINVAL && error.number() != ENOSYS) throw;
+    /* Don't lose any data already moved into the intermediate pipe: */
+    if (pending) {
+      std::vector<std::uint8_t> buffer(pending);
+      pipe_output.read(buffer.data(), buffer.size());
+      to.write(buffer.data(), buffer.size());
+      byte_count += pending;
+    }
+    return false;
+  }
+#else
+  (void)from, (void)from_offset, (void)to, (void)length, (void)byte_count;
+  return false;
+#endif /* __linux__ */
+}
+
+std::size_t
+posix::tee(const descriptor& from,
+           const descriptor& to,
+           const std::size_t length,
+           const unsigned int flags) {
+#ifdef __linux__
+retry:
+  const ssize_t rc = ::tee(from.fd(), to.fd(), length, flags);
+  if (rc == -1) {
+    switch (errno) {
+      case EINTR: /* Interrupted system call */
+        goto retry;
+      default:
+        throw_error("tee", "%d, %d, %zu, 0x%x", from.fd(), to.fd(), length, flags);
+    }
+  }
+  return static_cast<std::size_t>(rc);
+#else
+  (void)from, (void)to, (void)length, (void)flags;
+  throw_error(ENOSYS); /* Function not implemented */
+#endif /* __linux__ */
+}
+
+std::size_t
+posix::vmsplice(const descriptor& to,
+                const struct iovec* const iov,
+                const std::size_t iovcnt,
+                const unsigned int flags) {
+  assert(iov != nullptr || iovcnt == 0);
+
+#ifdef __linux__
+retry:
+  const ssize_t rc = ::vmsplice(to.fd(), iov, iovcnt, flags);
+  if (rc == -1) {
+    switch (errno) {
+      case EINTR: /* Interrupted system call */
+        goto retry;
+      default:
+        throw_error("vmsplice", "%d, %s, %zu, 0x%x", to.fd(), "iov", iovcnt, flags);
+    }
+  }
+  return static_cast<std::size_t>(rc);
+#else
+  (void)to, (void)iovcnt, (void)flags;
+  throw_error(ENOSYS); /* Function not implemented */
+#endif /* __linux__ */
+}
@@ -0,0 +1,100 @@
+/* This is free and unencumbered software released into the public domain. */
+
+#ifndef POSIXXX_SPLICE_H
+#define POSIXXX_SPLICE_H
+
+#ifndef __cplusplus
+#error "<posix++/splice.h> requires a C++ compiler"
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include <cstddef>     /* for std::size_t */
+#include <sys/types.h> /* for off_t */
+
+struct iovec; // @see <sys/uio.h>
+
+namespace posix {
+  struct descriptor; // @see <posix++/descriptor.h>
+
+  /**
+   * Moves data between two descriptors, at least one of which must be a
+   * pipe, without copying it through user space.
+   *
+   * The `flags` argument accepts `SPLICE_F_MOVE`, `SPLICE_F_NONBLOCK`,
+   * and `SPLICE_F_MORE`.
+   *
+   * Retries the operation automatically in case an `EINTR` (interrupted
+   * system call) error is encountered.
+   *
+   * @return the number of bytes moved, or zero on EOF
+   * @throws posix::error on failure
+   * @note This operation is Linux-specific.
+   * @see http://man7.org/linux/man-pages/man2/splice.2.html
+   */
+  std::size_t splice(const descriptor& from, const descriptor& to,
+    std::size_t length, unsigned int flags = 0);
+
+  /**
+   * Moves data between two descriptors, at least one of which must be a
+   * pipe, reading from and/or writing at explicit file offsets.
+   *
+   * An offset must be `nullptr` for the pipe side; otherwise, it is
+   * advanced by the number of bytes moved while the file offset of the
+   * corresponding descriptor is left unchanged.
+   *
+   * @copydetails splice(const descriptor&, const descriptor&, std::size_t, unsigned int)
+   */
+  std::size_t splice(const descriptor& from, off_t* from_offset,
+    const descriptor& to, off_t* to_offset,
+    std::size_t length, unsigned int flags = 0);
+
+  /**
+   * Moves data between two arbitrary descriptors by relaying it through
+   * an intermediate pipe, until EOF or until `length` bytes have been
+   * moved.
+   *
+   * If `from_offset` is non-null, reads start at that offset, which is
+   * advanced by the number of bytes moved, while the file offset of
+   * `from` is left unchanged.
+   *
+   * @param byte_count incremented by the number of bytes moved
+   * @return `true` on success, or `false` if either descriptor does not
+   *         support splicing; in the latter case, no data is left behind
+   *         in the intermediate pipe, and the caller may carry on with a
+   *         `read()`/`write()` loop
+   * @throws posix::error on failure
+   * @note This operation is Linux-specific.
+   */
+  bool splice_through_pipe(const descriptor& from, off_t* from_offset,
+    descriptor& to, std::size_t length, std::size_t& byte_count);
+
+  /**
+   * Duplicates data from one pipe to another without consuming it.
+   *
+   * @return the number of bytes duplicated, or zero if there was no data
+   * @throws posix::error on failure
+   * @note This operation is Linux-specific.
+   * @see http://man7.org/linux/man-pages/man2/tee.2.html
+   */
+  std::size_t tee(const descriptor& from, const descriptor& to,
+    std::size_t length, unsigned int flags = 0);
+
+  /**
+   * Maps user memory into a pipe.
+   *
+   * With `SPLICE_F_GIFT`, the pages are gifted to the kernel and must not
+   * be modified afterwards.
+   *
+   * @return the number of bytes transferred into the pipe
+   * @throws posix::error on failure
+   * @note This operation is Linux-specific.
+   * @see http://man7.org/linux/man-pages/man2/vmsplice.2.html
+   */
+  std::size_t vmsplice(const descriptor& to,
+    const struct iovec* iov, std::size_t iovcnt, unsigned int flags = 0);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif /* POSIXXX_SPLICE_H */
@@ -0,0 +1,211 @@
+/* This is free and unencumbered software released into the public domain. */
+
+#ifndef POSIXXX_STRING_SPAN_H
+#define POSIXXX_STRING_SPAN_H
+
+#ifndef __cplusplus
+#error "<posix++/string_span.h> requires a C++ compiler"
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include <cassert>  /* for assert() */
+#include <cstddef>  /* for std::ptrdiff_t, std::size_t */
+#include <cstring>  /* for std::memchr(), std::memcmp(), std::strlen() */
+#include <iterator> /* for std::forward_iterator_tag */
+#include <string>   /* for std::string */
+
+#if __cplusplus >= 201703L
+#include <string_view> /* for std::string_view */
+#endif
+
+namespace posix {
+  class string_span;
+  class string_split;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * A non-owning, read-only reference to a contiguous sequence of
+ * characters, such as a record in a memory-mapped file.
+ *
+ * This is a minimal stand-in for `std::string_view`, to which it
+ * implicitly converts in C++17 and later.
+ */
+class posix::string_span {
+  const char* _data;
+  std::size_t _size;
+
+public:
+  using value_type = char;
+  using const_iterator = const char*;
+
+  /**
+   * Default constructor.
+   */
+  string_span() noexcept
+    : _data{nullptr}, _size{0} {}
+
+  /**
+   * Constructor.
+   */
+  string_span(const char* const data, const std::size_t size) noexcept
+    : _data{data}, _size{size} {}
+
+  /**
+   * Constructor.
+   */
+  string_span(const char* const data) noexcept
+    : _data{data}, _size{std::strlen(data)} {}
+
+  /**
+   * Constructor.
+   */
+  string_span(const std::string& string) noexcept
+    : _data{string.data()}, _size{string.size()} {}
+
+  const char* data() const noexcept {
+    return _data;
+  }
+
+  std::size_t size() const noexcept {
+    return _size;
+  }
+
+  bool empty() const noexcept {
+    return _size == 0;
+  }
+
+  const char* begin() const noexcept {
+    return _data;
+  }
+
+  const char* end() const noexcept {
+    return _data + _size;
+  }
+
+  char operator[](const std::size_t index) const noexcept {
+    assert(index < _size);
+    return _data[index];
+  }
+
+  /**
+   * Returns a copy of the referenced characters.
+   */
+  std::string str() const {
+    return std::string{_data, _size};
+  }
+
+#if __cplusplus >= 201703L
+  operator std::string_view() const noexcept {
+    return std::string_view{_data, _size};
+  }
+#endif
+
+  bool operator==(const string_span& other) const noexcept {
+    return _size == other._size &&
+      (_size == 0 || std::memcmp(_data, other._data, _size) == 0);
+  }
+
+  bool operator!=(const string_span& other) const noexcept {
+    return !operator==(other);
+  }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * A range over the records of a character sequence delimited by a
+ * separator character, yielding each record as a `posix::string_span`
+ * without copying it.
+ *
+ * Separators are located with `std::memchr()`, which is vectorized on
+ * common platforms. The separators themselves are not included in the
+ * records, and a final separator does not yield an empty last record.
+ */
+class posix::string_split {
+  const char* _data;
+  std::size_t _size;
+  char _separator;
+
+public:
+  class iterator {
+    const char* _next; /* the start of the next record, or `nullptr` at the end */
+    const char* _end;
+    char _separator;
+    string_span _record;
+
+    void advance() noexcept {
+      if (_next == _end) {
+        _next = nullptr; /* all done */
+        return;
+      }
+      const auto found = static_cast<const char*>(
+        std::memchr(_next, _separator, static_cast<std::size_t>(_end - _next)));
+      const char* const record_end = found ? found : _end;
+      _record = string_span{_next, static_cast<std::size_t>(record_end - _next)};
+      _next = found ? found + 1 : _end;
+    }
+
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = string_span;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const string_span*;
+    using reference = const string_span&;
+
+    iterator() noexcept
+      : _next{nullptr}, _end{nullptr}, _separator{0} {}
+
+    iterator(const char* const data, const std::size_t size, const char separator) noexcept
+      : _next{data}, _end{data + size}, _separator{separator} {
+      advance();
+    }
+
+    reference operator*() const noexcept {
+      return _record;
+    }
+
+    pointer operator->() const noexcept {
+      return &_record;
+    }
+
+    iterator& operator++() noexcept {
+      advance();
+      return *this;
+    }
+
+    iterator operator++(int) noexcept {
+      iterator result{*this};
+      advance();
+      return result;
+    }
+
+    bool operator==(const iterator& other) const noexcept {
+      return _next == other._next && (_next == nullptr || _record.data() == other._record.data());
+    }
+
+    bool operator!=(const iterator& other) const noexcept {
+      return !operator==(other);
+    }
+  };
+
+  /**
+   * Constructor.
+   */
+  string_split(const char* const data, const std::size_t size, const char separator) noexcept
+    : _data{data}, _size{size}, _separator{separator} {}
+
+  iterator begin() const noexcept {
+    return iterator{_data, _size, _separator};
+  }
+
+  iterator end() const noexcept {
+    return iterator{};
+  }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif /* POSIXXX_STRING_SPAN_H */
@@ -5,11 +5,12 @@
 #endif
 
 #include "error.h"
+#include "memory_mapping.h"
+#include "numa_policy.h"
 #include "sysv_segment.h"
 
 #include <cassert>      /* for assert() */
 #include <cerrno>       /* for errno */
-#include <cstdio>       /* for std::sprintf() */
 #include <cstring>      /* for std::memset() */
 #include <sys/types.h>  /* for key_t */
 #include <sys/ipc.h>    /* for shm*() on BSD */
@@ -61,8 +62,24 @@ sysv_segment::create_unique(const std::size_t size,
  */
 sysv_segment
 sysv_segment::create(const key_t key,
-                     const std::size_t size,
+                     std::size_t size,
                      const int flags) {
+#ifdef SHM_HUGETLB
+  if (flags & SHM_HUGETLB) {
+    /* Round the size up to a multiple of the huge page size: */
+    std::size_t page_size = memory_mapping::huge_page_size();
+#ifdef SHM_HUGE_SHIFT
+    const int page_shift = (flags >> SHM_HUGE_SHIFT) & SHM_HUGE_MASK;
+    if (page_shift) {
+      page_size = std::size_t{1} << page_shift;
+    }
+#endif
+    if (page_size) {
+      size = (size + page_size - 1) / page_size * page_size;
+    }
+  }
+#endif /* SHM_HUGETLB */
+
   int shmid;
   if ((shmid = shmget(key, size, IPC_CREAT | flags)) == -1) {
     throw_error("shmget");
@@ -163,13 +180,7 @@ sysv_segment::remove() {
     if (shmctl(_id, IPC_RMID, nullptr) == -1) {
       assert(errno != EFAULT);
       if (errno != EINVAL && errno != EIDRM) {
-#if 1
-        char buffer[256];
-        std::sprintf(buffer, "shmctl(%d, IPC_RMID, NULL)", _id);
-        throw_error(buffer);
-#else
-        throw_error("shmctl(IPC_RMID)");
-#endif
+        throw_error("shmctl", "%d, %s, %s", _id, "IPC_RMID", "NULL");
       }
     }
   }
@@ -200,6 +211,19 @@ sysv_segment::unlock() {
 #endif
 }
 
+void
+sysv_segment::set_numa_policy(const numa_policy& policy,
+                              const bool move) {
+  assert(is_attached());
+  policy.apply(_addr, size(), move);
+}
+
+std::vector<int>
+sysv_segment::numa_placement() {
+  assert(is_attached());
+  return numa_policy::placement(_addr, size());
+}
+
 void
 sysv_segment::clear() noexcept {
   assert(is_attached());
@@ -14,8 +14,10 @@
 #include <functional> /* for std::function */
 #include <sys/ipc.h>  /* for key_t */
 #include <sys/shm.h>  /* for shmid_ds */
+#include <vector>     /* for std::vector */
 
 namespace posix {
+  class numa_policy;
   class sysv_segment;
 }
 
@@ -52,6 +54,10 @@ public:
   /**
    * Creates a new segment.
    *
+   * With `SHM_HUGETLB` in `flags`, the segment is backed by huge pages,
+   * and `size` is rounded up to a multiple of the huge page size, which
+   * may be selected with `SHM_HUGE_2MB` or `SHM_HUGE_1GB`.
+   *
    * @throws posix::error on failure
    */
   static sysv_segment create(key_t key, std::size_t size, int flags = 0600);
@@ -221,6 +227,27 @@ public:
    */
   void unlock();
 
+  /**
+   * Applies a NUMA placement policy to this segment, so that its pages
+   * are allocated from the policy's nodes when first touched, by this or
+   * any other process.
+   *
+   * @pre `is_attached()` must be `true`.
+   * @param move whether to also migrate pages already allocated
+   * @throws posix::error on failure
+   * @note This does nothing on machines with a single NUMA node.
+   */
+  void set_numa_policy(const numa_policy& policy, bool move = false);
+
+  /**
+   * Returns the NUMA node on which each page of this segment resides.
+   *
+   * @pre `is_attached()` must be `true`.
+   * @throws posix::error on failure
+   * @see posix::numa_policy::placement()
+   */
+  std::vector<int> numa_placement();
+
   void clear() noexcept;
 };
 
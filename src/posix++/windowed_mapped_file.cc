@@ -0,0 +1,217 @@
+/* This is free and unencumbered software released into the public domain. */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "windowed_mapped_file.h"
+
+#include "directory.h"
+#include "error.h"
+#include "pathname.h"
+
+#include <algorithm> /* for std::min() */
+#include <cassert>   /* for assert() */
+#include <cerrno>    /* for EINVAL */
+#include <cstring>   /* for std::memchr(), std::memcpy() */
+#include <fcntl.h>   /* for AT_FDCWD */
+#include <unistd.h>  /* for _SC_PAGE_SIZE, sysconf() */
+#include <utility>   /* for std::swap() */
+
+using namespace posix;
+
+constexpr std::size_t windowed_mapped_file::default_window_size;
+
+////////////////////////////////////////////////////////////////////////////////
+
+windowed_mapped_file
+windowed_mapped_file::open(const pathname& pathname,
+                           const int flags,
+                           const mode mode,
+                           const std::size_t window_size) {
+
+  return windowed_mapped_file{AT_FDCWD, pathname.c_str(), flags, mode, window_size};
+}
+
+windowed_mapped_file
+windowed_mapped_file::open(const directory& directory,
+                           const pathname& pathname,
+                           const int flags,
+                           const mode mode,
+                           const std::size_t window_size) {
+
+  return windowed_mapped_file{directory.fd(), pathname.c_str(), flags, mode, window_size};
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+  static std::size_t system_page_size() {
+    return static_cast<std::size_t>(::sysconf(_SC_PAGE_SIZE));
+  }
+}
+
+windowed_mapped_file::windowed_mapped_file(const int dirfd,
+                                           const char* const pathname,
+                                           const int flags,
+                                           const mode mode,
+                                           const std::size_t window_size)
+  : file{dirfd, pathname, flags, mode},
+    _size{file::size()},
+    _offset{0},
+    _window_size{0},
+    _window_offset{0},
+    _window{nullptr, 0} {
+
+  const std::size_t page_size = system_page_size();
+  _window_size = std::max(page_size,
+    (window_size + page_size - 1) / page_size * page_size);
+}
+
+windowed_mapped_file::windowed_mapped_file(windowed_mapped_file&& other) noexcept
+  : windowed_mapped_file{} {
+
+  std::swap(_fd, other._fd);
+  std::swap(_size, other._size);
+  std::swap(_offset, other._offset);
+  std::swap(_window_size, other._window_size);
+  std::swap(_window_offset, other._window_offset);
+  std::swap(_window, other._window);
+}
+
+windowed_mapped_file&
+windowed_mapped_file::operator=(windowed_mapped_file&& other) noexcept {
+  if (this != &other) {
+    std::swap(_fd, other._fd);
+    std::swap(_size, other._size);
+    std::swap(_offset, other._offset);
+    std::swap(_window_size, other._window_size);
+    std::swap(_window_offset, other._window_offset);
+    std::swap(_window, other._window);
+  }
+  return *this;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void
+windowed_mapped_file::slide(const std::size_t offset) {
+  assert(offset < _size);
+
+  const std::size_t window_offset = offset - offset % _window_size;
+  const std::size_t length = std::min(_window_size, _size - window_offset);
+
+  _window = memory_mapping{fd(), length, window_offset, PROT_READ, MAP_SHARED};
+  _window_offset = window_offset;
+}
+
+const char*
+windowed_mapped_file::cursor(std::size_t& available) {
+  assert(!is_eof());
+
+  if (_offset < _window_offset || _offset >= _window_offset + _window.size()) {
+    slide(_offset);
+  }
+  available = _window_offset + _window.size() - _offset;
+  return _window.data<char>(_offset - _window_offset);
+}
+
+void
+windowed_mapped_file::sync() {
+  const std::size_t new_size = file::size();
+  if (new_size != _size) {
+    _size = new_size;
+    _window = memory_mapping{nullptr, 0}; /* remap on next access */
+    _window_offset = 0;
+  }
+}
+
+std::size_t
+windowed_mapped_file::seek(const off_t offset,
+                           const int whence) {
+  off_t base;
+  switch (whence) {
+    case SEEK_SET: base = 0; break;
+    case SEEK_CUR: base = static_cast<off_t>(_offset); break;
+    case SEEK_END: base = static_cast<off_t>(_size); break;
+    default:
+      throw_error(EINVAL, "seek", "%lld, %d", static_cast<long long>(offset), whence);
+  }
+  if (base + offset < 0) {
+    throw_error(EINVAL, "seek", "%lld, %d", static_cast<long long>(offset), whence);
+  }
+  _offset = static_cast<std::size_t>(base + offset);
+  return _offset;
+}
+
+std::size_t
+windowed_mapped_file::read_line(std::string& buffer) {
+  return read_until('\n', buffer); /* read_until() updates _offset */
+}
+
+std::size_t
+windowed_mapped_file::read_until(const char separator,
+                                 std::string& buffer) {
+  std::size_t byte_count = 0;
+  while (!is_eof()) {
+    std::size_t available;
+    const char* const data = cursor(available);
+    const char* const match =
+      reinterpret_cast<const char*>(std::memchr(data, separator, available));
+    if (match) {
+      const std::size_t length = static_cast<std::size_t>(match - data);
+      buffer.append(data, length);
+      _offset += length + 1;
+      byte_count += length + 1;
+      break; /* all done */
+    }
+    /* The record straddles the window edge; carry on with the next: */
+    buffer.append(data, available);
+    _offset += available;
+    byte_count += available;
+  }
+  return byte_count;
+}
+
+std::size_t
+windowed_mapped_file::read(char& result) {
+  if (is_eof()) {
+    return 0; /* EOF */
+  }
+  std::size_t available;
+  result = *cursor(available);
+  _offset++;
+  return 1;
+}
+
+std::size_t
+windowed_mapped_file::read(void* const buffer,
+                           const std::size_t buffer_size) {
+  assert(buffer != nullptr);
+
+  std::size_t byte_count = 0;
+  while (byte_count < buffer_size && !is_eof()) {
+    std::size_t available;
+    const char* const data = cursor(available);
+    const std::size_t length = std::min(available, buffer_size - byte_count);
+    std::memcpy(reinterpret_cast<char*>(buffer) + byte_count, data, length);
+    _offset += length;
+    byte_count += length;
+  }
+  return byte_count;
+}
+
+std::string
+windowed_mapped_file::read() {
+  std::string buffer;
+  if (!is_eof()) {
+    buffer.reserve(_size - _offset);
+    while (!is_eof()) {
+      std::size_t available;
+      const char* const data = cursor(available);
+      buffer.append(data, available);
+      _offset += available;
+    }
+  }
+  return buffer;
+}
@@ -0,0 +1,183 @@
+/* This is free and unencumbered software released into the public domain. */
+
+#ifndef POSIXXX_WINDOWED_MAPPED_FILE_H
+#define POSIXXX_WINDOWED_MAPPED_FILE_H
+
+#ifndef __cplusplus
+#error "<posix++/windowed_mapped_file.h> requires a C++ compiler"
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include "file.h"
+#include "memory_mapping.h"
+
+#include <cstddef> /* for std::size_t */
+#include <string>  /* for std::string */
+
+namespace posix {
+  class windowed_mapped_file;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * A memory-mapped file for sequential or random access that only maps a
+ * fixed-size window of the file at a time.
+ *
+ * The window is page-aligned and slides along as the current offset
+ * moves, so that arbitrarily large files can be read within a bounded
+ * address space. Reads that straddle a window edge are handled
+ * transparently.
+ *
+ * @see posix::mapped_file
+ */
+class posix::windowed_mapped_file : public posix::file {
+protected:
+  std::size_t _size;
+  std::size_t _offset;
+  std::size_t _window_size;
+  std::size_t _window_offset;
+  memory_mapping _window;
+
+  /**
+   * Returns a pointer to the current offset, sliding the window as
+   * needed, along with the number of bytes mapped from there on.
+   *
+   * @pre `is_eof()` must be `false`.
+   */
+  const char* cursor(std::size_t& available);
+
+  void slide(std::size_t offset);
+
+public:
+  /**
+   * The default window size in bytes.
+   */
+  static constexpr std::size_t default_window_size = 1024 * 1024;
+
+  /**
+   * Opens a file for windowed reading.
+   *
+   * @param window_size the window size, rounded up to a multiple of the
+   *                    page size
+   */
+  static windowed_mapped_file open(const pathname& pathname, int flags, mode mode = 0,
+    std::size_t window_size = default_window_size);
+
+  /**
+   * @copydoc open(const pathname&, int, mode, std::size_t)
+   */
+  static windowed_mapped_file open(const directory& directory, const pathname& pathname,
+    int flags, mode mode = 0, std::size_t window_size = default_window_size);
+
+  /**
+   * Default constructor.
+   */
+  windowed_mapped_file() noexcept
+    : file{}, _size{0}, _offset{0}, _window_size{0}, _window_offset{0},
+      _window{nullptr, 0} {}
+
+  /**
+   * Constructor.
+   */
+  windowed_mapped_file(int dirfd, const char* pathname, int flags, mode mode = 0,
+    std::size_t window_size = default_window_size);
+
+  /**
+   * Move constructor.
+   */
+  windowed_mapped_file(windowed_mapped_file&& other) noexcept;
+
+  /**
+   * Move assignment operator.
+   */
+  windowed_mapped_file& operator=(windowed_mapped_file&& other) noexcept;
+
+  /**
+   * Checks whether this file's size is zero.
+   */
+  bool empty() const noexcept {
+    return size() == 0;
+  }
+
+  /**
+   * Returns the file size in bytes, as of opening or the last `sync()`.
+   */
+  std::size_t size() const noexcept {
+    return _size;
+  }
+
+  /**
+   * Returns the current offset.
+   */
+  std::size_t offset() const noexcept {
+    return _offset;
+  }
+
+  /**
+   * Returns the window size in bytes.
+   */
+  std::size_t window_size() const noexcept {
+    return _window_size;
+  }
+
+  /**
+   * Updates the file size, e.g. after the file was appended to.
+   *
+   * @post `size()` returns the current file size
+   */
+  void sync();
+
+  /**
+   * Sets the current offset to the beginning of the file.
+   */
+  void rewind() noexcept {
+    _offset = 0;
+  }
+
+  /**
+   * Checks whether the current offset is at or past EOF.
+   */
+  bool is_eof() const noexcept {
+    return offset() >= size();
+  }
+
+  /**
+   * Returns or changes the current offset. Unlike `posix::file::seek()`,
+   * this leaves the underlying file offset unchanged.
+   *
+   * @throws posix::invalid_argument if the resulting offset is negative
+   */
+  std::size_t seek(off_t offset, int whence = SEEK_SET);
+
+  /**
+   * Reads a line of text from this file.
+   */
+  std::size_t read_line(std::string& buffer);
+
+  /**
+   * Reads data from this file until the given separator character
+   * is encountered.
+   */
+  std::size_t read_until(char separator, std::string& buffer);
+
+  /**
+   * Reads a character from this file.
+   */
+  std::size_t read(char& result);
+
+  /**
+   * Reads data from this file.
+   */
+  std::size_t read(void* buffer, std::size_t buffer_size);
+
+  /**
+   * Reads a string from this file.
+   */
+  std::string read();
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif /* POSIXXX_WINDOWED_MAPPED_FILE_H */
@@ -0,0 +1,82 @@
+/* This is free and unencumbered software released into the public domain. */
+
+#include "catch.hpp"
+
+#include <posix++/arena.h> /* for posix::arena, posix::arena_allocator */
+#include <posix++/error.h> /* for posix::fatal_error */
+
+#include <cstdint> /* for std::uintptr_t */
+#include <cstring> /* for std::memset() */
+#include <vector>  /* for std::vector */
+
+using namespace posix;
+
+TEST_CASE("test_allocate") {
+  arena arena{1024 * 1024};
+  REQUIRE(arena.capacity() == 1024 * 1024);
+  REQUIRE(arena.used() == 0);
+
+  char* const a = static_cast<char*>(arena.allocate(3, 1));
+  REQUIRE(arena.used() == 3);
+  REQUIRE(arena.owns(a));
+
+  void* const b = arena.allocate(64, 64);
+  REQUIRE((reinterpret_cast<std::uintptr_t>(b) % 64) == 0);
+  REQUIRE(arena.owns(b));
+  std::memset(b, 0xFF, 64);
+
+  /* Only the most recent allocation is reclaimed: */
+  const auto used = arena.used();
+  arena.deallocate(a, 3, 1);
+  REQUIRE(arena.used() == used);
+  arena.deallocate(b, 64, 64);
+  REQUIRE(arena.used() == used - 64);
+}
+
+TEST_CASE("test_reset") {
+  arena arena{64 * 1024};
+  void* const a = arena.allocate(1000);
+  arena.reset();
+  REQUIRE(arena.used() == 0);
+  REQUIRE(arena.allocate(1000) == a);
+
+  arena.release();
+  REQUIRE(arena.used() == 0);
+  REQUIRE(!arena.owns(a));
+  REQUIRE(arena.allocate(1000) == a);
+}
+
+TEST_CASE("test_grow") {
+  arena arena{4096};
+  arena.allocate(4096, 1);
+  try {
+    void* const p = arena.allocate(8192, 1);
+    REQUIRE(arena.capacity() >= 3 * 4096);
+    std::memset(p, 0, 8192);
+  }
+  catch (const posix::fatal_error&) {
+    /* the address space just past the mapping was taken */
+  }
+}
+
+TEST_CASE("test_allocator") {
+  arena arena;
+  std::vector<int, arena_allocator<int>> vector{arena_allocator<int>{arena}};
+  for (int i = 0; i < 1000; i++) {
+    vector.push_back(i);
+  }
+  REQUIRE(vector.size() == 1000);
+  REQUIRE(vector[999] == 999);
+  REQUIRE(arena.owns(vector.data()));
+  REQUIRE(arena_allocator<int>{arena} == arena_allocator<char>{arena});
+}
+
+#ifdef POSIXXX_ARENA_PMR
+TEST_CASE("test_resource") {
+  arena arena;
+  arena_resource resource{arena};
+  std::pmr::vector<int> vector{&resource};
+  vector.assign(1000, 42);
+  REQUIRE(arena.owns(vector.data()));
+}
+#endif
@@ -0,0 +1,74 @@
+/* This is free and unencumbered software released into the public domain. */
+
+#include "catch.hpp"
+#include "helpers.h"
+
+#include <posix++/buffered_reader.h> /* for posix::buffered_reader */
+#include <posix++/descriptor.h>      /* for posix::descriptor */
+
+#include <utility> /* for std::move() */
+
+using namespace posix;
+
+TEST_CASE("test_read_line") {
+  auto pipe = make_pipe("Hello,\nworld!\nbye");
+  buffered_reader reader{pipe.first, 4}; /* lines straddle refills */
+  std::string line;
+  REQUIRE(reader.read_line(line) == 7);
+  REQUIRE(line == "Hello,");
+  line.clear();
+  REQUIRE(reader.read_line(line) == 7);
+  REQUIRE(line == "world!");
+  line.clear();
+  REQUIRE(reader.read_line(line) == 3);
+  REQUIRE(line == "bye");
+  line.clear();
+  REQUIRE(reader.read_line(line) == 0);
+}
+
+TEST_CASE("test_read_lines") {
+  auto pipe = make_pipe("b\na\nb\n");
+  buffered_reader reader{pipe.first};
+  std::set<std::string> lines;
+  REQUIRE(reader.read_lines(lines) == 6);
+  REQUIRE(lines == (std::set<std::string>{"a", "b"}));
+}
+
+TEST_CASE("test_read") {
+  auto pipe = make_pipe("0123456789abcdef");
+  buffered_reader reader{pipe.first, 4};
+  char c;
+  REQUIRE(reader.read(c) == 1);
+  REQUIRE(c == '0');
+  char buffer[9] = {};
+  REQUIRE(reader.read(buffer, 8) == 8);
+  REQUIRE(std::string{buffer} == "12345678");
+  REQUIRE(reader.read() == "9abcdef");
+  REQUIRE(reader.read(c) == 0);
+}
+
+TEST_CASE("test_release") {
+  auto pipe = make_pipe("line\nrest");
+  buffered_reader reader{pipe.first};
+  std::string line;
+  reader.read_line(line);
+  REQUIRE(reader.buffered() == 4);
+  REQUIRE(reader.release() == "rest");
+  REQUIRE(reader.buffered() == 0);
+}
+
+TEST_CASE("test_move") {
+  auto pipe = make_pipe("line\nrest");
+  buffered_reader reader{pipe.first};
+  std::string line;
+  reader.read_line(line);
+
+  buffered_reader other{std::move(reader)};
+  REQUIRE(reader.buffered() == 0);
+  REQUIRE(reader.release().empty());
+  REQUIRE(other.buffered() == 4);
+
+  reader = std::move(other);
+  REQUIRE(other.buffered() == 0);
+  REQUIRE(reader.read() == "rest");
+}
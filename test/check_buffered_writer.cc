@@ -0,0 +1,77 @@
+/* This is free and unencumbered software released into the public domain. */
+
+#include "catch.hpp"
+#include "helpers.h"
+
+#include <posix++/buffered_writer.h> /* for posix::buffered_writer */
+#include <posix++/descriptor.h>      /* for posix::descriptor */
+#include <posix++/error.h>           /* for posix::error */
+
+#include <fcntl.h>  /* for F_SETFL, F_SETPIPE_SZ, O_NONBLOCK */
+#include <string>   /* for std::string */
+
+using namespace posix;
+
+TEST_CASE("test_write_line") {
+  auto pipe = make_pipe();
+  {
+    buffered_writer writer{pipe.second};
+    writer.write_line("Hello,");
+    writer.write_line(std::string{"world!"});
+    REQUIRE(writer.buffered() == 14);
+  } /* flushes on destruction */
+  pipe.second.close();
+  REQUIRE(pipe.first.read() == "Hello,\nworld!\n");
+}
+
+TEST_CASE("test_write_overflow") {
+  auto pipe = make_pipe();
+  buffered_writer writer{pipe.second, 4};
+  writer.write("ab");
+  writer.write('c');
+  REQUIRE(writer.buffered() == 3);
+  writer.write("defgh"); /* written together with the buffer contents */
+  REQUIRE(writer.buffered() == 0);
+  writer.write_line("ijklm");
+  REQUIRE(writer.buffered() == 0);
+  writer.write('n');
+  writer.flush();
+  REQUIRE(writer.buffered() == 0);
+  pipe.second.close();
+  REQUIRE(pipe.first.read() == "abcdefghijklm\nn");
+}
+
+TEST_CASE("test_write_partial") {
+  auto pipe = make_pipe();
+#ifdef F_SETPIPE_SZ
+  pipe.second.fcntl(F_SETPIPE_SZ, 4096);
+#endif
+  pipe.second.fcntl(F_SETFL, O_NONBLOCK);
+
+  /* Fill the pipe until a flush fails midway with EAGAIN: */
+  const std::string chunk(5000, 'x'); /* more than PIPE_BUF, so not atomic */
+  std::size_t written = 0;
+  buffered_writer writer{pipe.second, 2 * chunk.size()};
+  for (;;) {
+    writer.write(chunk.data(), chunk.size());
+    written += chunk.size();
+    try {
+      writer.flush();
+    }
+    catch (const posix::error&) {
+      break;
+    }
+  }
+  REQUIRE(writer.buffered() < chunk.size()); /* the written part was dropped */
+
+  /* Drain the pipe, then flush the rest, which must not be duplicated: */
+  std::size_t read = 0;
+  char buffer[4096];
+  while (read < written - writer.buffered()) {
+    read += pipe.first.read(buffer, sizeof(buffer));
+  }
+  writer.flush();
+  pipe.second.close();
+  read += pipe.first.read().size();
+  REQUIRE(read == written);
+}
@@ -1,9 +1,79 @@
 /* This is free and unencumbered software released into the public domain. */
 
 #include "catch.hpp"
+#include "helpers.h"
 
 #include <posix++/descriptor.h> /* for posix::descriptor */
 
+#include <cerrno>    /* for EAGAIN */
+#include <fcntl.h>   /* for F_SETFL, O_NONBLOCK */
+#include <sys/uio.h> /* for struct iovec */
+
+using namespace posix;
+
 TEST_CASE("test_descriptor") {
   // TODO
 }
+
+TEST_CASE("test_write_line") {
+  auto pipe = make_pipe();
+  descriptor& input = pipe.first;
+  descriptor& output = pipe.second;
+  output.write_line("Hello, world!");
+  output.close();
+  REQUIRE(input.read() == "Hello, world!\n");
+}
+
+TEST_CASE("test_readv_writev") {
+  auto pipe = make_pipe();
+  descriptor& input = pipe.first;
+  descriptor& output = pipe.second;
+
+  char header[] = "HEAD", body[] = "payload";
+  const struct iovec out[3] = {{header, 4}, {nullptr, 0}, {body, 7}};
+  output.write(out, 3);
+  output.close();
+
+  char a[6] = {}, b[16] = {};
+  const struct iovec in[2] = {{a, 5}, {b, sizeof(b) - 1}};
+  REQUIRE(input.read(in, 2) == 11);
+  REQUIRE(std::string{a} == "HEADp");
+  REQUIRE(std::string{b} == "ayload");
+}
+
+TEST_CASE("test_preadv_pwritev") {
+  auto file = make_temporary_file();
+
+  char data[] = "0123456789";
+  const struct iovec out[2] = {{data, 5}, {data + 5, 5}};
+  REQUIRE(file.pwrite(out, 2, 100) == 10);
+
+  char a[4] = {}, b[4] = {};
+  const struct iovec in[2] = {{a, 3}, {b, 3}};
+  REQUIRE(file.pread(in, 2, 102) == 6);
+  REQUIRE(std::string{a} == "234");
+  REQUIRE(std::string{b} == "567");
+}
+
+TEST_CASE("test_try_read_write") {
+  auto pipe = make_pipe();
+  descriptor& input = pipe.first;
+  descriptor& output = pipe.second;
+  input.fcntl(F_SETFL, O_NONBLOCK);
+
+  char buffer[8];
+  const auto empty = input.try_read(buffer, sizeof(buffer));
+  REQUIRE(!empty.ok());
+  REQUIRE(empty.would_block());
+
+  const auto written = output.try_write("hello", 5);
+  REQUIRE(written.ok());
+  REQUIRE(*written == 5);
+
+  const auto read = input.try_read(buffer, sizeof(buffer));
+  REQUIRE(read.ok());
+  REQUIRE(*read == 5);
+
+  output.close();
+  REQUIRE(input.try_read(buffer, sizeof(buffer)).value() == 0); /* EOF */
+}
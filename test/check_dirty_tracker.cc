@@ -0,0 +1,68 @@
+/* This is free and unencumbered software released into the public domain. */
+
+#include "catch.hpp"
+#include "helpers.h"
+
+#include <posix++/descriptor.h>     /* for posix::descriptor */
+#include <posix++/dirty_tracker.h>  /* for posix::dirty_tracker */
+#include <posix++/memory_mapping.h> /* for posix::memory_mapping */
+
+#include <cstring>    /* for std::memcmp(), std::memset() */
+#include <sys/mman.h> /* for MAP_*, MS_*, PROT_* */
+#include <unistd.h>   /* for pread(), sysconf() */
+
+using namespace posix;
+
+static const std::size_t page_size = static_cast<std::size_t>(::sysconf(_SC_PAGE_SIZE));
+
+TEST_CASE("test_mark") {
+  auto file = make_temporary_file(16 * page_size);
+  memory_mapping mapping{file, 16 * page_size, 0, PROT_READ | PROT_WRITE, MAP_SHARED};
+  dirty_tracker tracker{mapping};
+  REQUIRE(tracker.empty());
+
+  tracker.mark(1, 1); /* widened to a page */
+  REQUIRE(tracker.range_count() == 1);
+  REQUIRE(tracker.dirty_size() == page_size);
+  REQUIRE(tracker.is_dirty(0));
+  REQUIRE(!tracker.is_dirty(page_size));
+
+  tracker.mark(4 * page_size, 2 * page_size);
+  REQUIRE(tracker.range_count() == 2);
+  REQUIRE(tracker.dirty_size() == 3 * page_size);
+
+  tracker.mark(page_size - 1, 2); /* adjacent to both ranges */
+  REQUIRE(tracker.range_count() == 2);
+  tracker.mark(2 * page_size, 2 * page_size); /* bridges the gap */
+  REQUIRE(tracker.range_count() == 1);
+  REQUIRE(tracker.dirty_size() == 6 * page_size);
+
+  tracker.mark(15 * page_size, 10 * page_size); /* clamped */
+  REQUIRE(tracker.dirty_size() == 7 * page_size);
+  tracker.mark(16 * page_size, 1); /* out of range */
+  REQUIRE(tracker.range_count() == 2);
+
+  tracker.clear();
+  REQUIRE(tracker.empty());
+  REQUIRE(tracker.dirty_size() == 0);
+}
+
+TEST_CASE("test_flush") {
+  auto file = make_temporary_file(16 * page_size);
+  memory_mapping mapping{file, 16 * page_size, 0, PROT_READ | PROT_WRITE, MAP_SHARED};
+  dirty_tracker tracker{mapping};
+
+  std::memset(mapping.data(3 * page_size + 10), 'x', 5);
+  tracker.mark(3 * page_size + 10, 5);
+  std::memset(mapping.data(9 * page_size), 'y', page_size);
+  tracker.mark(9 * page_size, page_size);
+  REQUIRE(tracker.range_count() == 2);
+
+  tracker.flush();
+  REQUIRE(tracker.empty());
+  REQUIRE(tracker.dirty_size() == 0);
+
+  char buffer[5];
+  REQUIRE(::pread(file.fd(), buffer, sizeof(buffer), static_cast<off_t>(3 * page_size + 10)) == 5);
+  REQUIRE(std::memcmp(buffer, "xxxxx", 5) == 0);
+}
@@ -4,6 +4,76 @@
 
 #include <posix++/error.h> /* for posix::error */
 
+#include <cerrno>  /* for E* */
+#include <cstring> /* for std::strerror() */
+#include <string>  /* for std::string */
+
+using namespace posix;
+
+static std::string
+what_of(const int code,
+        const char* const origin,
+        const char* const format,
+        ...) {
+  va_list args;
+  va_start(args, format);
+  try {
+    throw_error(code, origin, format, args);
+  }
+  catch (const posix::error& error) {
+    va_end(args);
+    return error.what();
+  }
+}
+
 TEST_CASE("test_error") {
-  // TODO
+  REQUIRE_THROWS_AS(throw_error(EBADF), const posix::bad_descriptor&);
+  REQUIRE_THROWS_AS(throw_error(EINVAL, "f"), const posix::invalid_argument&);
+  REQUIRE_THROWS_AS(throw_error(ENOMEM, "f"), const posix::fatal_error&);
+  REQUIRE_THROWS_AS(throw_error(ENOSYS, "f"), const posix::logic_error&);
+  REQUIRE_THROWS_AS(throw_error(ENOENT, "f"), const posix::runtime_error&);
+}
+
+TEST_CASE("test_what") {
+  const std::string message{std::strerror(ENOENT)};
+  REQUIRE(what_of(ENOENT, nullptr, nullptr) == message);
+  REQUIRE(what_of(ENOENT, "open", nullptr) == "open(): " + message);
+  REQUIRE(what_of(ENOENT, "openat", "%d, \"%s\", 0x%x, 0%o", -100, "/tmp/x", 0x80000u, 0644u) ==
+    "openat(-100, \"/tmp/x\", 0x80000, 0644): " + message);
+  REQUIRE(what_of(ENOENT, "read", "%d, %s, %zu", 3, "chunk", std::size_t{4096}) ==
+    "read(3, chunk, 4096): " + message);
+  REQUIRE(what_of(ENOENT, "f", "%lld, %ld, %*d, %.*s, %c, %%", -1LL, 2L, 4, 7, 3, "abcdef", 'z') ==
+    "f(-1, 2,    7, abc, z, %): " + message);
+  REQUIRE(what_of(ENOENT, "f", "%s", static_cast<const char*>(nullptr)) ==
+    "f((null)): " + message);
+}
+
+TEST_CASE("test_what_long") {
+  const std::string argument(8192, 'x');
+  const std::string what = what_of(EIO, "write", "%s", argument.c_str());
+  REQUIRE(what.compare(0, 7, "write(x") == 0); /* truncated, not overflowed */
+  REQUIRE(what.find("): ") != std::string::npos);
+}
+
+TEST_CASE("test_what_copy") {
+  try {
+    throw_error(EACCES, "unlink", "\"%s\"", "/etc/passwd");
+  }
+  catch (const posix::error& error) {
+    const posix::error copy{error};
+    REQUIRE(std::string{copy.what()} == error.what());
+    REQUIRE(copy.number() == EACCES);
+  }
+}
+
+TEST_CASE("test_what_lazy") {
+  const std::string message{std::strerror(ENOENT)};
+  try {
+    std::string pathname{"/tmp/check_error"};
+    throw_error(ENOENT, "open", "\"%s\", 0%o", pathname.c_str(), 0644u);
+  }
+  catch (const posix::error& error) { /* `pathname` is gone by now */
+    REQUIRE(std::string{error.what()} == "open(\"/tmp/check_error\", 0644): " + message);
+    REQUIRE(error.what() == error.what()); /* formatted only once */
+  }
 }
@@ -1,9 +1,48 @@
 /* This is free and unencumbered software released into the public domain. */
 
 #include "catch.hpp"
+#include "helpers.h"
 
-#include <posix++/file.h> /* for posix::file */
+#include <posix++/file.h>     /* for posix::file */
+#include <posix++/pathname.h> /* for posix::pathname */
+
+#include <cerrno>  /* for ENOENT */
+#include <fcntl.h> /* for O_APPEND, O_RDONLY */
+
+using namespace posix;
 
 TEST_CASE("test_file") {
   // TODO
 }
+
+TEST_CASE("test_copy_to") {
+  file source{make_temporary_file().release()};
+  file target{make_temporary_file().release()};
+  source.write("Hello, world!");
+  target.write(">");
+  REQUIRE(source.copy_to(target, 7) == 6);
+  REQUIRE(source.offset() == 13);
+  REQUIRE(source.copy_to(target, 0, 5) == 5);
+  REQUIRE(target.size() == 12);
+  target.rewind();
+  REQUIRE(target.read() == ">world!Hello");
+}
+
+TEST_CASE("test_copy_to_append") {
+  file source{make_temporary_file().release()};
+  file target{make_temporary_file().release()};
+  source.write("Hello, world!");
+  target.fcntl(F_SETFL, O_APPEND);
+  REQUIRE(source.copy_to(target) == 13);
+  REQUIRE(target.size() == 13);
+}
+
+TEST_CASE("test_try_open") {
+  const auto missing = file::try_open(pathname{"/nonexistent/check_file"}, O_RDONLY);
+  REQUIRE(!missing.ok());
+  REQUIRE(missing.is(ENOENT));
+
+  auto found = file::try_open(pathname{"/dev/null"}, O_RDONLY);
+  REQUIRE(found.ok());
+  REQUIRE(found->valid());
+}
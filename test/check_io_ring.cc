@@ -0,0 +1,138 @@
+/* This is free and unencumbered software released into the public domain. */
+
+#include "catch.hpp"
+#include "helpers.h"
+
+#include <posix++/descriptor.h> /* for posix::descriptor */
+#include <posix++/error.h>      /* for posix::error */
+#include <posix++/io_ring.h>    /* for posix::io_ring */
+
+#include <cerrno>       /* for ENOSYS */
+#include <cstring>      /* for std::memcmp() */
+#include <sys/socket.h> /* for socketpair() */
+#include <sys/uio.h>    /* for struct iovec */
+
+using namespace posix;
+
+TEST_CASE("test_unsupported") {
+  if (io_ring::supported()) return;
+  try {
+    io_ring ring;
+    FAIL("io_ring constructed without io_uring support");
+  }
+  catch (const posix::error& error) {
+    REQUIRE(error.code().value() != 0);
+  }
+}
+
+TEST_CASE("test_read_write") {
+  if (!io_ring::supported()) return;
+  io_ring ring{8};
+  REQUIRE(ring.capacity() == 8);
+  auto file = make_temporary_file();
+
+  ring.write(file, "Hello, ", 7, 0, 1);
+  ring.write(file, "world!", 6, 7, 2);
+  REQUIRE(ring.pending() == 2);
+  REQUIRE(ring.submit_and_wait(2) == 2);
+  REQUIRE(ring.pending() == 0);
+
+  io_completion completion;
+  std::uint64_t seen = 0;
+  while (ring.pop(completion)) {
+    REQUIRE((completion.result == 7 || completion.result == 6));
+    seen |= completion.user_data;
+  }
+  REQUIRE(seen == 3);
+
+  ring.fsync(file, 0, 3);
+  REQUIRE(ring.wait().result == 0);
+
+  char head[5], tail[8];
+  struct iovec iov[2] = {{head, sizeof(head)}, {tail, sizeof(tail)}};
+  ring.readv(file, iov, 2, 0, 4);
+  completion = ring.wait();
+  REQUIRE(completion.user_data == 4);
+  REQUIRE(completion.result == 13);
+  REQUIRE(std::memcmp(head, "Hello", 5) == 0);
+  REQUIRE(std::memcmp(tail, ", world!", 8) == 0);
+}
+
+TEST_CASE("test_overflow") {
+  if (!io_ring::supported()) return;
+  io_ring ring{2};
+  auto file = make_temporary_file();
+
+  for (int i = 0; i < 5; i++) {
+    ring.write(file, "x", 1, i, i); /* auto-submits when full */
+  }
+  for (int i = 0; i < 5; i++) {
+    REQUIRE(ring.wait().result == 1);
+  }
+  io_completion completion;
+  REQUIRE(!ring.pop(completion));
+}
+
+TEST_CASE("test_registered") {
+  if (!io_ring::supported()) return;
+  io_ring ring;
+  auto file = make_temporary_file();
+
+  const int fds[] = {file.fd()};
+  ring.register_files(fds, 1);
+
+  char buffer[16] = "registered";
+  struct iovec iov = {buffer, sizeof(buffer)};
+  ring.register_buffers(&iov, 1);
+
+  ring.write_fixed(file, buffer, 10, 0, 0, 1);
+  REQUIRE(ring.wait().result == 10);
+
+  std::memset(buffer, 0, sizeof(buffer));
+  ring.read_fixed(file, buffer, sizeof(buffer), 0, 0, 2);
+  REQUIRE(ring.wait().result == 10);
+  REQUIRE(std::memcmp(buffer, "registered", 10) == 0);
+
+  ring.unregister_buffers();
+  ring.unregister_files();
+}
+
+TEST_CASE("test_send_recv_close") {
+  if (!io_ring::supported()) return;
+  io_ring ring;
+
+  int fds[2];
+  REQUIRE(::socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == 0);
+  descriptor left{fds[0]}, right{fds[1]};
+
+  char buffer[8] = {};
+  ring.recv(right, buffer, sizeof(buffer), 0, 1);
+  ring.send(left, "ping", 4, 0, 2);
+  ring.submit_and_wait(2);
+  io_completion completion;
+  for (int i = 0; i < 2; i++) {
+    REQUIRE(ring.pop(completion));
+    REQUIRE(completion.result == 4);
+  }
+  REQUIRE(std::memcmp(buffer, "ping", 4) == 0);
+
+  ring.close(left, 3);
+  REQUIRE(!left.valid());
+  REQUIRE(ring.wait().result == 0);
+  REQUIRE(right.read(buffer, sizeof(buffer)) == 0); /* EOF */
+}
+
+TEST_CASE("test_close_registered") {
+  if (!io_ring::supported()) return;
+  io_ring ring;
+
+  int fds[2];
+  REQUIRE(::socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == 0);
+  descriptor left{fds[0]}, right{fds[1]};
+  ring.register_files(fds, 1);
+
+  ring.close(left, 1);
+  REQUIRE(ring.wait().result == 0);
+  char buffer[8];
+  REQUIRE(right.read(buffer, sizeof(buffer)) == 0); /* EOF, so really closed */
+}
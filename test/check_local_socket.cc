@@ -1,11 +1,20 @@
 /* This is free and unencumbered software released into the public domain. */
 
 #include "catch.hpp"
+#include "helpers.h"
 
-#include <posix++/local_socket.h> /* for posix::local_socket */
-#include <posix++/pathname.h>     /* for posix::pathname */
+#include <posix++/file.h>          /* for posix::file */
+#include <posix++/local_socket.h>  /* for posix::local_socket */
+#include <posix++/pathname.h>      /* for posix::pathname */
+#include <posix++/ring_buffer.h>   /* for posix::ring_buffer */
+#include <posix++/shared_buffer.h> /* for posix::shared_buffer */
 
+#include <cerrno>       /* for EAGAIN */
+#include <cstring>      /* for std::memcmp(), std::memcpy() */
+#include <fcntl.h>      /* for O_NONBLOCK, fcntl() */
 #include <sys/socket.h> /* for AF_LOCAL, SOCK_STREAM */
+#include <sys/uio.h>    /* for struct iovec */
+#include <unistd.h>     /* for unlink() */
 
 using namespace posix;
 
@@ -30,6 +39,91 @@ TEST_CASE("test_pair") {
   REQUIRE(s2.recv_string() == "Hello, world!");
 }
 
+TEST_CASE("test_sendmsg_recvmsg") {
+  auto sp = local_socket::pair();
+
+  char header[] = "HEAD", body[] = "payload";
+  const struct iovec out[2] = {{header, 4}, {body, 7}};
+  sp.first.send(out, 2);
+  sp.first.close_write();
+
+  char a[3] = {}, b[16] = {};
+  const struct iovec in[2] = {{a, 2}, {b, sizeof(b) - 1}};
+  REQUIRE(sp.second.recv(in, 2) == 11);
+  REQUIRE(std::string{a} == "HE");
+  REQUIRE(std::string{b} == "ADpayload");
+}
+
+TEST_CASE("test_send_file") {
+  file source{make_temporary_file().release()};
+  source.write("Hello, world!");
+
+  auto sp = local_socket::pair();
+  REQUIRE(sp.first.send_file(source, 7) == 6);
+  REQUIRE(sp.first.send_file(source, 0, 5) == 5);
+  sp.first.close_write();
+  REQUIRE(sp.second.recv_string() == "world!Hello");
+}
+
+TEST_CASE("test_try_send_recv") {
+  auto sp = local_socket::pair();
+  REQUIRE(::fcntl(sp.second.fd(), F_SETFL, O_NONBLOCK) == 0);
+
+  char buffer[8];
+  REQUIRE(sp.second.try_recv(buffer, sizeof(buffer)).would_block());
+  REQUIRE(sp.first.try_send("hello", 5).value() == 5);
+  REQUIRE(sp.second.try_recv(buffer, sizeof(buffer)).value() == 5);
+  sp.first.close_write();
+  REQUIRE(sp.second.try_recv(buffer, sizeof(buffer)).value() == 0);
+}
+
+TEST_CASE("test_recv_ring_buffer") {
+  auto sp = local_socket::pair();
+  ring_buffer buffer{1};
+  buffer.commit(buffer.capacity() - 2);
+  buffer.consume(buffer.capacity() - 2);
+
+  sp.first.send("hello", 5);
+  REQUIRE(buffer.recv_from(sp.second) == 5);
+  REQUIRE(std::string(reinterpret_cast<const char*>(buffer.data()), buffer.size()) == "hello");
+}
+
+#ifdef F_ADD_SEALS
+TEST_CASE("test_send_shared_buffer") {
+  auto sp = local_socket::pair();
+  {
+    auto buffer = shared_buffer::create(1024 * 1024);
+    std::memcpy(buffer.map(PROT_READ | PROT_WRITE).data(), "Hello", 5);
+    buffer.seal(F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_WRITE | F_SEAL_SEAL);
+    sp.first.send_descriptor(buffer);
+  }
+  shared_buffer buffer{sp.second.recv_descriptor()};
+  REQUIRE(buffer.sealed(F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_WRITE));
+  REQUIRE(buffer.size() == 1024 * 1024);
+  REQUIRE(std::memcmp(buffer.map().data(), "Hello", 5) == 0);
+}
+#endif
+
+TEST_CASE("test_try_accept") {
+  char dirname[] = "/tmp/check_local_socket.XXXXXX";
+  REQUIRE(::mkdtemp(dirname) != nullptr);
+  const std::string path = std::string{dirname} + "/socket";
+
+  auto server = local_socket::bind(pathname{path});
+  server.listen();
+  REQUIRE(::fcntl(server.fd(), F_SETFL, O_NONBLOCK) == 0);
+  REQUIRE(server.try_accept().would_block());
+
+  auto client = local_socket::connect(pathname{path});
+  auto connection = server.try_accept();
+  REQUIRE(connection.ok());
+  client.send("x", 1);
+  REQUIRE(connection->recv_chunk() == "x");
+
+  ::unlink(path.c_str());
+  ::rmdir(dirname);
+}
+
 TEST_CASE("test_connect") {
   // TODO
 }
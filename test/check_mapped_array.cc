@@ -0,0 +1,96 @@
+/* This is free and unencumbered software released into the public domain. */
+
+#include "catch.hpp"
+#include "helpers.h"
+
+#include <posix++/error.h>        /* for posix::error */
+#include <posix++/mapped_array.h> /* for posix::mapped_array */
+
+#include <algorithm> /* for std::is_sorted(), std::lower_bound(), std::sort() */
+#include <cstdint>   /* for std::uint32_t, std::uint64_t */
+#include <fcntl.h>   /* for O_RDONLY, O_RDWR */
+#include <numeric>   /* for std::accumulate() */
+#include <unistd.h>  /* for unlink() */
+#include <vector>    /* for std::vector */
+
+using namespace posix;
+
+namespace {
+  struct record {
+    std::uint32_t key;
+    std::uint32_t value;
+  };
+}
+
+static std::string
+make_file(const void* const data, const std::size_t size) {
+  return make_temporary_path(std::string(static_cast<const char*>(data), size));
+}
+
+TEST_CASE("test_read") {
+  std::vector<record> records;
+  for (std::uint32_t i = 0; i < 1000; i++) {
+    records.push_back(record{2 * i, i});
+  }
+  const auto pathname = make_file(records.data(), records.size() * sizeof(record));
+  auto array = mapped_array<record>::open(pathname, O_RDONLY);
+  ::unlink(pathname.c_str());
+
+  REQUIRE(array.size() == 1000);
+  REQUIRE(array[999].key == 1998);
+
+  const auto match = std::lower_bound(array.begin(), array.end(), 500,
+    [](const record& r, const std::uint32_t key) { return r.key < key; });
+  REQUIRE(match != array.end());
+  REQUIRE(match->value == 250);
+
+  const auto span = array.subspan(10, 5);
+  REQUIRE(span.size() == 5);
+  REQUIRE(span[0].value == 10);
+  REQUIRE((span.end() - span.begin()) == 5);
+
+  REQUIRE_THROWS_AS(array.push_back(record{0, 0}), const posix::bad_descriptor&);
+  REQUIRE_THROWS_AS(array.resize(2000), const posix::bad_descriptor&);
+  REQUIRE(array.size() == 1000);
+}
+
+TEST_CASE("test_sort") {
+  std::vector<std::uint64_t> values;
+  for (std::uint64_t i = 0; i < 4096; i++) {
+    values.push_back((i * 2654435761U) % 4096);
+  }
+  const auto pathname = make_file(values.data(), values.size() * sizeof(std::uint64_t));
+  {
+    auto array = mapped_array<std::uint64_t>::open(pathname, O_RDWR);
+    std::sort(array.begin(), array.end());
+    array.push_back(4096);
+    array.flush();
+  }
+  const auto array = mapped_array<std::uint64_t>::open(pathname, O_RDONLY);
+  ::unlink(pathname.c_str());
+  REQUIRE(array.size() == 4097);
+  REQUIRE(std::is_sorted(array.begin(), array.end()));
+  REQUIRE(std::accumulate(array.begin(), array.end(), std::uint64_t{0}) ==
+    std::accumulate(values.begin(), values.end(), std::uint64_t{4096}));
+}
+
+TEST_CASE("test_validate") {
+  const char header[] = "HEADER\n\0\1\2\3\4\5\6\7";
+  const auto pathname = make_file(header, 16);
+
+  /* The records must fill the file after the header: */
+  REQUIRE_THROWS_AS(mapped_array<std::uint64_t>::open(pathname, O_RDONLY, 4),
+    const posix::error&);
+  /* The records must be aligned: */
+  REQUIRE_THROWS_AS(mapped_array<std::uint32_t>::open(pathname, O_RDONLY, 4 + 2),
+    const posix::error&);
+  /* The records must be in the native byte order: */
+  const auto foreign = byte_order::native == byte_order::little ?
+    byte_order::big : byte_order::little;
+  REQUIRE_THROWS_AS(mapped_array<std::uint64_t>::open(pathname, O_RDONLY, 8, foreign),
+    const posix::error&);
+
+  const auto array = mapped_array<std::uint64_t>::open(pathname, O_RDONLY, 8, byte_order::native);
+  ::unlink(pathname.c_str());
+  REQUIRE(array.size() == 1);
+}
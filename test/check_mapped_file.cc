@@ -1,9 +1,347 @@
 /* This is free and unencumbered software released into the public domain. */
 
 #include "catch.hpp"
+#include "helpers.h"
 
+#include <posix++/descriptor.h>  /* for posix::descriptor */
+#include <posix++/error.h>       /* for posix::error */
 #include <posix++/mapped_file.h> /* for posix::mapped_file */
+#include <posix++/pathname.h>    /* for posix::pathname */
+
+#include <algorithm> /* for std::sort() */
+#include <atomic>    /* for std::atomic */
+#include <cstdint>   /* for std::uint64_t */
+#include <fcntl.h>   /* for O_*, open() */
+#include <mutex>     /* for std::lock_guard, std::mutex */
+#include <stdexcept> /* for std::runtime_error */
+#include <string>    /* for std::string */
+#include <unistd.h>  /* for unlink() */
+#include <vector>    /* for std::vector */
+
+#include <sys/mman.h> /* for MAP_POPULATE */
+
+using namespace posix;
+
+static mapped_file
+make_mapped_file(const std::string& contents) {
+  const auto pathname = make_temporary_path(contents);
+  mapped_file result = mapped_file::open(pathname, O_RDONLY);
+  ::unlink(pathname.c_str());
+  return result;
+}
 
 TEST_CASE("test_file") {
   // TODO
 }
+
+TEST_CASE("test_stream") {
+  std::string contents;
+  for (int i = 0; contents.size() < 1024 * 1024; i++) {
+    contents.append(std::to_string(i)).push_back('\n');
+  }
+  auto file = make_mapped_file(contents);
+  REQUIRE(!file.streaming());
+  file.stream(64 * 1024);
+  REQUIRE(file.streaming());
+
+  std::string result, line;
+  while (file.read_line(line)) {
+    result.append(line).push_back('\n');
+    line.clear();
+  }
+  REQUIRE(result == contents);
+  REQUIRE(file.is_eof());
+
+  file.rewind();
+  REQUIRE(file.read() == contents);
+
+  file.stream(0);
+  REQUIRE(!file.streaming());
+}
+
+TEST_CASE("test_prewarm") {
+  const std::string contents(5 * 1024 * 1024, 'x');
+  auto file = make_mapped_file(contents);
+
+  std::size_t calls = 0, done = 0;
+  REQUIRE(!file.prewarm(0, -1, false, [&](std::size_t d, std::size_t total) {
+    REQUIRE(total == contents.size());
+    REQUIRE(d > done);
+    done = d;
+    calls++;
+  }).joinable());
+  REQUIRE(calls == 2);
+  REQUIRE(done == contents.size());
+
+  auto residency = file.residency();
+  REQUIRE((residency.pages.size() * residency.page_size) >= contents.size());
+  REQUIRE(residency.percentage() > 0);
+
+  done = 0;
+  auto thread = file.prewarm(1024 * 1024, 1000, true, [&](std::size_t d, std::size_t) {
+    done = d;
+  });
+  REQUIRE(thread.joinable());
+  thread.join();
+  REQUIRE(done == 1000);
+
+  {
+    auto other = make_mapped_file(contents);
+    thread = other.prewarm(0, -1, true);
+  } /* the thread outlives the file and its mapping */
+  thread.join();
+
+  file.prewarm(contents.size(), 1); /* out of range */
+}
+
+TEST_CASE("test_read_until") {
+  auto file = make_mapped_file("a,bc,,d");
+  std::string buffer;
+  REQUIRE(file.read_until(',', buffer) == 2);
+  REQUIRE(buffer == "a");
+  REQUIRE(file.read_until(',', buffer) == 3);
+  REQUIRE(buffer == "abc");
+  buffer.clear();
+  REQUIRE(file.read_until(',', buffer) == 1);
+  REQUIRE(buffer.empty());
+  REQUIRE(file.read_until(',', buffer) == 1);
+  REQUIRE(buffer == "d");
+  REQUIRE(file.is_eof());
+  REQUIRE(file.read_until(',', buffer) == 0);
+}
+
+TEST_CASE("test_lines") {
+  auto file = make_mapped_file("Hello,\nworld!\n\nbye");
+  std::vector<std::string> lines;
+  for (const auto& line : file.lines()) {
+    lines.push_back(line.str());
+  }
+  REQUIRE(lines == (std::vector<std::string>{"Hello,", "world!", "", "bye"}));
+  REQUIRE(file.offset() == 0);
+
+  std::size_t count = 0;
+  for (const auto& field : file.split(',')) {
+    count += field.size();
+  }
+  REQUIRE(count == file.size() - 1);
+}
+
+TEST_CASE("test_preallocate") {
+  const auto pathname = make_temporary_path("header\n");
+  {
+    auto file = appendable_mapped_file::open(pathname, O_RDWR);
+    REQUIRE(!file.preallocating());
+    file.preallocate(4096);
+    REQUIRE(file.preallocating());
+    REQUIRE(file.size() == 7);
+
+    std::string expected{"header\n"};
+    for (int i = 0; i < 1000; i++) {
+      const std::string record = std::to_string(i) + '\n';
+      REQUIRE(file.append(record) == expected.size());
+      expected.append(record);
+    }
+    REQUIRE(file.size() == expected.size());
+    REQUIRE(file.file::size() > expected.size()); /* preallocated */
+    REQUIRE(file.seek(0, SEEK_END) == expected.size());
+
+    file.sync();
+    file.rewind();
+    REQUIRE(file.read() == expected);
+  }
+  auto file = mapped_file::open(pathname, O_RDONLY);
+  ::unlink(pathname.c_str());
+  REQUIRE(file.size() == file.file::size()); /* truncated */
+
+  std::string line;
+  REQUIRE(file.read_line(line) == 7);
+  REQUIRE(line == "header");
+}
+
+TEST_CASE("test_preallocate_close") {
+  const auto pathname = make_temporary_path();
+  auto file = appendable_mapped_file::open(pathname, O_RDWR);
+  file.preallocate(4096);
+  file.append(std::string{"Hello"});
+  file.close();
+  REQUIRE(!file.valid());
+
+  auto result = mapped_file::open(pathname, O_RDONLY);
+  ::unlink(pathname.c_str());
+  REQUIRE(result.read() == "Hello");
+
+  auto other = appendable_mapped_file::open(pathname, O_RDWR | O_CREAT, 0600);
+  ::unlink(pathname.c_str());
+  other.preallocate(4096);
+  other.append(std::string{"Hello"});
+  other.preallocate(0);
+  REQUIRE(!other.preallocating());
+  REQUIRE(other.file::size() == 5);
+  REQUIRE(other.append(std::string{", world!"}) == 5);
+}
+
+TEST_CASE("test_preallocate_base") {
+  const auto pathname = make_temporary_path();
+  {
+    auto file = appendable_mapped_file::open(pathname, O_RDWR);
+    file.preallocate(4096);
+    file.append(std::string{"Hello"});
+
+    /* The logical end survives calls through base class references: */
+    mapped_file& base = file;
+    base.sync();
+    REQUIRE(file.size() == 5);
+    REQUIRE(base.seek(0, SEEK_END) == 5);
+    REQUIRE(file.preallocating());
+    file.append(std::string{", world!"});
+  }
+  {
+    auto file = mapped_file::open(pathname, O_RDONLY);
+    REQUIRE(file.file::size() == 13); /* truncated on destruction */
+    REQUIRE(file.read() == "Hello, world!");
+  }
+  {
+    auto file = appendable_mapped_file::open(pathname, O_RDWR);
+    file.preallocate(4096);
+    file.append(std::string{"!"});
+    mapped_file& base = file;
+    base.close();
+    REQUIRE(!file.preallocating());
+  }
+  auto file = mapped_file::open(pathname, O_RDONLY);
+  ::unlink(pathname.c_str());
+  REQUIRE(file.file::size() == 14); /* truncated on close */
+}
+
+TEST_CASE("test_preallocate_flags") {
+  struct probe : appendable_mapped_file {
+    using appendable_mapped_file::appendable_mapped_file;
+    int mapping_flags() const noexcept { return _mapping.flags(); }
+  };
+  const auto pathname = make_temporary_path();
+  probe file{AT_FDCWD, pathname.c_str(), O_RDWR, 0, MAP_POPULATE};
+  ::unlink(pathname.c_str());
+
+  /* Growing or dropping the preallocation keeps the mapping flags: */
+  file.preallocate(4096);
+  file.append(std::string(3 * 4096, '.'));
+  REQUIRE(file.size() == 3 * 4096);
+  REQUIRE((file.mapping_flags() & MAP_POPULATE));
+  file.preallocate(0);
+  REQUIRE((file.mapping_flags() & MAP_POPULATE));
+  REQUIRE(file.file::size() == 3 * 4096);
+}
+
+TEST_CASE("test_write") {
+  const auto pathname = make_temporary_path("Hello, world!");
+  {
+    auto file = mapped_file::open(pathname, O_RDWR);
+    file.write(7, std::string{"there"});
+    REQUIRE(file.size() == 13);
+
+    /* Writing past the end grows the file and the mapping: */
+    const std::string padding(3 * 4096 + 3, '.');
+    file.write(13, padding);
+    REQUIRE(file.size() == 13 + padding.size());
+    REQUIRE(file.file::size() == file.size());
+
+    REQUIRE((file.size() % alignof(std::uint64_t)) == 0);
+    auto& counter = file.at<std::uint64_t>(file.size());
+    REQUIRE(file.size() == 13 + padding.size() + sizeof(std::uint64_t));
+    REQUIRE(counter == 0);
+    for (int i = 0; i < 42; i++) {
+      counter++;
+    }
+    file.flush();
+  }
+  auto file = mapped_file::open(pathname, O_RDONLY);
+  ::unlink(pathname.c_str());
+  REQUIRE(file.size() == 16 + 3 * 4096 + sizeof(std::uint64_t));
+  const mapped_file& view = file; /* read-only */
+  REQUIRE(view.at<std::uint64_t>(file.size() - sizeof(std::uint64_t)) == 42);
+
+  std::string line;
+  file.read_line(line);
+  REQUIRE(line.substr(0, 13) == "Hello, there!");
+}
+
+TEST_CASE("test_write_overflow") {
+  const auto pathname = make_temporary_path();
+  auto file = mapped_file::open(pathname, O_RDWR);
+  ::unlink(pathname.c_str());
+  REQUIRE_THROWS_AS(file.write(static_cast<std::size_t>(-2), std::string{"xyz"}),
+    const posix::error&);
+  REQUIRE_THROWS_AS(file.at<std::uint64_t>(static_cast<std::size_t>(-8)),
+    const posix::error&);
+  REQUIRE(file.size() == 0);
+}
+
+TEST_CASE("test_write_read_only") {
+  auto file = make_mapped_file("Hello");
+  REQUIRE_THROWS_AS(file.write(0, std::string{"J"}), const posix::bad_descriptor&);
+  REQUIRE_THROWS_AS(file.at<char>(0), const posix::bad_descriptor&);
+  REQUIRE_THROWS_AS(file.resize(4096), const posix::bad_descriptor&);
+  REQUIRE(file[0] == 'H');
+}
+
+TEST_CASE("test_seek_cur") {
+  auto file = make_mapped_file("Hello");
+  REQUIRE(file.seek(3, SEEK_CUR) == 3);
+  REQUIRE(file.seek(-3, SEEK_CUR) == 0);
+  REQUIRE_THROWS_AS(file.seek(-1, SEEK_CUR), const posix::invalid_argument&);
+  REQUIRE(file.offset() == 0);
+}
+
+TEST_CASE("test_seek_end") {
+  const auto pathname = make_temporary_path("Hello");
+  descriptor output{::open(pathname.c_str(), O_WRONLY | O_APPEND)};
+  auto file = mapped_file::open(pathname, O_RDONLY);
+  ::unlink(pathname.c_str());
+  REQUIRE(file.size() == 5);
+
+  /* Seeking to the end maps through data appended since: */
+  const std::string padding(2 * 4096, '.');
+  output.write(padding);
+  REQUIRE(file.seek(-1, SEEK_END) == 5 + padding.size() - 1);
+  REQUIRE(file.size() == 5 + padding.size());
+  char c;
+  REQUIRE(file.read(c) == 1);
+  REQUIRE(c == '.');
+}
+
+TEST_CASE("test_parallel_for_each_record") {
+  std::string contents;
+  for (int i = 0; i < 100000; i++) {
+    contents.append(std::to_string(i)).push_back('\n');
+  }
+  const auto file = make_mapped_file(contents);
+
+  for (const unsigned int nthreads : {0U, 1U, 3U, 8U}) {
+    std::atomic<std::size_t> count{0}, sum{0};
+    file.parallel_for_each_record('\n', nthreads, [&](const string_span record) {
+      count++;
+      sum += std::stoul(std::string{record.data(), record.size()});
+    });
+    REQUIRE(count == 100000);
+    REQUIRE(sum == 99999UL * 100000 / 2);
+  }
+
+  /* Records never straddle chunks, even when longer than a chunk: */
+  const auto small = make_mapped_file("a,bb,,ccc");
+  std::mutex mutex;
+  std::vector<std::string> records;
+  small.parallel_for_each_record(',', 16, [&](const string_span record) {
+    std::lock_guard<std::mutex> lock{mutex};
+    records.emplace_back(record.data(), record.size());
+  });
+  std::sort(records.begin(), records.end());
+  REQUIRE(records == (std::vector<std::string>{"", "a", "bb", "ccc"}));
+
+  REQUIRE_THROWS_AS(file.parallel_for_each_record('\n', 4, [](const string_span) {
+    throw std::runtime_error{"stop"};
+  }), const std::runtime_error&);
+
+  make_mapped_file("").parallel_for_each_record('\n', 4, [](const string_span) {
+    FAIL("no records expected");
+  });
+}
@@ -1,9 +1,17 @@
 /* This is free and unencumbered software released into the public domain. */
 
 #include "catch.hpp"
+#include "helpers.h"
 
+#include <posix++/descriptor.h>     /* for posix::descriptor */
+#include <posix++/error.h>          /* for posix::error */
 #include <posix++/memory_mapping.h> /* for posix::memory_mapping */
 
+#include <cstring>    /* for std::memcmp(), std::memcpy() */
+#include <sys/mman.h> /* for MAP_*, PROT_* */
+#include <unistd.h>   /* for pread() */
+#include <utility>    /* for std::move() */
+
 using namespace posix;
 
 static std::uint8_t buffer[0x1000] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
@@ -28,3 +36,123 @@ TEST_CASE("test_operator_bool") {
 TEST_CASE("test_operator_at") {
   REQUIRE(memory_mapping(buffer, sizeof(buffer))[1] == buffer[1]);
 }
+
+TEST_CASE("test_protection") {
+  auto file = make_temporary_file("Hello, world!");
+
+  memory_mapping read_only{file, 13, 0};
+  REQUIRE(read_only.readable());
+  REQUIRE(!read_only.writable());
+  REQUIRE(!read_only.executable());
+  REQUIRE(read_only.shared());
+  REQUIRE(std::memcmp(read_only.data(), "Hello", 5) == 0);
+
+  memory_mapping read_write{file, 13, 0, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE};
+  REQUIRE(read_write.writable());
+  REQUIRE(read_write.protection() == (PROT_READ | PROT_WRITE));
+  std::memcpy(read_write.data(), "HELLO", 5);
+  REQUIRE(std::memcmp(read_only.data(), "HELLO", 5) == 0); /* shared */
+}
+
+TEST_CASE("test_private") {
+  auto file = make_temporary_file("Hello, world!");
+
+  memory_mapping copy{file, 13, 0, PROT_READ | PROT_WRITE, MAP_PRIVATE};
+  REQUIRE(!copy.shared());
+  std::memcpy(copy.data(), "HELLO", 5);
+
+  char buffer[5];
+  REQUIRE(::pread(file.fd(), buffer, sizeof(buffer), 0) == 5);
+  REQUIRE(std::memcmp(buffer, "Hello", 5) == 0); /* copy-on-write */
+}
+
+#ifdef MAP_FIXED_NOREPLACE
+TEST_CASE("test_fixed_noreplace") {
+  auto file = make_temporary_file("Hello, world!");
+
+  memory_mapping first{file, 13, 0};
+  REQUIRE_THROWS_AS(memory_mapping(file, 13, 0, PROT_READ, MAP_SHARED | MAP_FIXED_NOREPLACE,
+    first.data()), const posix::error&);
+}
+#endif
+
+TEST_CASE("test_move") {
+  auto file = make_temporary_file("Hello, world!");
+
+  memory_mapping first{file, 13, 0};
+  const std::uint8_t* const data = first.data();
+  memory_mapping second{std::move(first)};
+  REQUIRE(!first);
+  REQUIRE(second.data() == data);
+
+  memory_mapping third{file, 13, 0, PROT_READ | PROT_WRITE, MAP_PRIVATE};
+  third = std::move(second);
+  REQUIRE(!second);
+  REQUIRE(third.data() == data);
+  REQUIRE(!third.writable());
+}
+
+TEST_CASE("test_anonymous") {
+  auto mapping = memory_mapping::anonymous(8192);
+  REQUIRE(mapping.size() == 8192);
+  REQUIRE(mapping.writable());
+  REQUIRE(!mapping.shared());
+  REQUIRE(mapping[8191] == 0);
+  mapping.data()[8191] = 42;
+  REQUIRE(mapping[8191] == 42);
+}
+
+TEST_CASE("test_huge") {
+  const std::size_t page_size = memory_mapping::huge_page_size();
+  auto mapping = memory_mapping::huge(1);
+  REQUIRE(mapping.writable());
+  if (page_size) {
+    REQUIRE(mapping.size() == page_size);
+    REQUIRE((reinterpret_cast<std::uintptr_t>(mapping.data()) % page_size) == 0);
+  }
+  mapping.data()[mapping.size() - 1] = 42;
+  REQUIRE(mapping[mapping.size() - 1] == 42);
+  if (!mapping.hugetlb()) {
+    WARN("no explicit huge pages available; using transparent huge pages");
+  }
+}
+
+TEST_CASE("test_advise") {
+  auto mapping = memory_mapping::anonymous(4 * 4096);
+  mapping.advise(MADV_SEQUENTIAL);
+  mapping.advise(4096 + 1, 100, MADV_WILLNEED); /* widened to a page */
+  mapping.advise(mapping.size(), 4096, MADV_WILLNEED); /* out of range */
+  mapping.data()[0] = 42;
+  mapping.advise(0, 1, MADV_DONTNEED);
+  REQUIRE(mapping[0] == 0); /* anonymous pages are zero-filled again */
+  REQUIRE_THROWS_AS(mapping.advise(0, 1, -1), const posix::error&);
+}
+
+TEST_CASE("test_sync") {
+  auto file = make_temporary_file("Hello, world!");
+
+  memory_mapping mapping{file, 13, 0, PROT_READ | PROT_WRITE, MAP_SHARED};
+  std::memcpy(mapping.data(7), "WORLD", 5);
+  mapping.sync(7, 5);
+  mapping.sync(0, 1, MS_ASYNC | MS_INVALIDATE);
+  mapping.sync(mapping.size(), 1); /* out of range */
+  mapping.sync();
+
+  char buffer[5];
+  REQUIRE(::pread(file.fd(), buffer, sizeof(buffer), 7) == 5);
+  REQUIRE(std::memcmp(buffer, "WORLD", 5) == 0);
+  REQUIRE_THROWS_AS(mapping.sync(0, 1, MS_SYNC | MS_ASYNC), const posix::error&);
+}
+
+TEST_CASE("test_residency") {
+  auto mapping = memory_mapping::anonymous(4 * 4096);
+  mapping.data()[2 * 4096] = 42;
+  const auto residency = mapping.residency();
+  REQUIRE((residency.pages.size() * residency.page_size) == mapping.size());
+  REQUIRE(residency.pages[2 * 4096 / residency.page_size]);
+  REQUIRE(residency.resident_count() >= 1);
+  REQUIRE(residency.percentage() > 0);
+
+  REQUIRE(mapping.residency(4096 + 1, 1).pages.size() == 1); /* widened */
+  REQUIRE(mapping.residency(mapping.size(), 1).pages.empty()); /* out of range */
+}
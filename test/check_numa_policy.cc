@@ -0,0 +1,44 @@
+/* This is free and unencumbered software released into the public domain. */
+
+#include "catch.hpp"
+
+#include <posix++/memory_mapping.h> /* for posix::memory_mapping */
+#include <posix++/numa_policy.h>    /* for posix::numa_policy */
+
+#include <cerrno>   /* for ENOENT */
+#include <cstddef>  /* for std::size_t */
+#include <unistd.h> /* for sysconf() */
+
+using namespace posix;
+
+static const std::size_t page_size = static_cast<std::size_t>(::sysconf(_SC_PAGE_SIZE));
+
+TEST_CASE("test_node_count") {
+  REQUIRE(numa_policy::node_count() >= 1);
+  REQUIRE(numa_policy::supported() == (numa_policy::node_count() > 1));
+}
+
+TEST_CASE("test_nodes") {
+  REQUIRE(numa_policy::bind(0).contains(0));
+  REQUIRE(!numa_policy::bind(0).contains(1));
+  REQUIRE(numa_policy::bind({1, 70}).contains(70));
+  REQUIRE(!numa_policy::bind({1, 70}).contains(0));
+  REQUIRE(numa_policy::interleave().contains(0) == numa_policy::interleave({0}).contains(0));
+  REQUIRE(!numa_policy::default_policy().contains(0));
+  REQUIRE(numa_policy::bind(0).mode() != numa_policy::preferred(0).mode());
+}
+
+TEST_CASE("test_apply") {
+  auto mapping = memory_mapping::anonymous(4 * page_size);
+  mapping.set_numa_policy(numa_policy::bind(0));
+  mapping.set_numa_policy(numa_policy::interleave());
+  mapping.set_numa_policy(numa_policy::preferred(0), true);
+  mapping.data()[0] = 42;
+
+  const auto placement = mapping.numa_placement();
+  REQUIRE(placement.size() == 4);
+  REQUIRE(placement[0] == 0);
+  REQUIRE((placement[1] == 0 || placement[1] == -ENOENT));
+
+  numa_policy::default_policy().apply();
+}
@@ -0,0 +1,65 @@
+/* This is free and unencumbered software released into the public domain. */
+
+#include "catch.hpp"
+#include "helpers.h"
+
+#include <posix++/descriptor.h> /* for posix::descriptor */
+#include <posix++/poll_set.h>   /* for posix::poll_set */
+
+#include <csignal> /* for sigemptyset() */
+
+using namespace posix;
+
+TEST_CASE("test_add_remove") {
+  poll_set set;
+  auto a = make_pipe(), b = make_pipe(), c = make_pipe();
+  set.add(a.first, POLLIN);
+  set.add(b.first, POLLIN);
+  set.add(c.first, POLLIN);
+  set.add(b.first, POLLIN | POLLPRI); /* modify */
+  REQUIRE(set.size() == 3);
+  REQUIRE(set.fds()[1].events == (POLLIN | POLLPRI));
+
+  set.remove(a.first);
+  REQUIRE(set.size() == 2);
+  REQUIRE(!set.contains(a.first));
+  REQUIRE(set.fds()[0].fd == c.first.fd()); /* swapped into place */
+  set.remove(a.first); /* idempotent */
+  REQUIRE(set.size() == 2);
+
+  set.clear();
+  REQUIRE(set.empty());
+}
+
+TEST_CASE("test_wait") {
+  poll_set set;
+  auto a = make_pipe(), b = make_pipe(), c = make_pipe();
+  set.add(a.first, POLLIN);
+  set.add(b.first, POLLIN);
+  set.add(c.first, POLLIN);
+
+  REQUIRE(set.wait(0) == 0);
+  REQUIRE(set.ready().empty());
+
+  b.second.write('x');
+  c.second.write('y');
+  REQUIRE(set.wait(0) == 2);
+  REQUIRE(set.ready()[0].fd == b.first.fd());
+  REQUIRE(set.ready()[1].fd == c.first.fd());
+  REQUIRE((set.ready()[0].revents & POLLIN) != 0);
+}
+
+TEST_CASE("test_wait_timespec") {
+  poll_set set;
+  auto a = make_pipe();
+  set.add(a.first, POLLIN);
+
+  const struct timespec timeout = {0, 1000000};
+  REQUIRE(set.wait(&timeout) == 0);
+
+  sigset_t sigmask;
+  sigemptyset(&sigmask);
+  a.second.write('x');
+  REQUIRE(set.wait(&timeout, &sigmask) == 1);
+  REQUIRE(set.ready()[0].fd == a.first.fd());
+}
@@ -0,0 +1,96 @@
+/* This is free and unencumbered software released into the public domain. */
+
+#include "catch.hpp"
+#include "helpers.h"
+
+#include <posix++/descriptor.h> /* for posix::descriptor */
+#include <posix++/reactor.h>    /* for posix::reactor */
+
+#include <unistd.h> /* for dup() */
+
+#ifdef __linux__
+#include <sys/epoll.h> /* for EPOLL* */
+
+using namespace posix;
+
+TEST_CASE("test_poll") {
+  reactor reactor;
+  auto pipe = make_pipe();
+
+  int ready_fd = -1;
+  unsigned int ready_events = 0;
+  reactor.add(pipe.first, EPOLLIN, [&](const int fd, const unsigned int events) {
+    ready_fd = fd;
+    ready_events = events;
+  });
+  REQUIRE(reactor.size() == 1);
+  REQUIRE(reactor.contains(pipe.first));
+
+  REQUIRE(reactor.poll(0) == 0);
+  pipe.second.write('x');
+  REQUIRE(reactor.poll(0) == 1);
+  REQUIRE(ready_fd == pipe.first.fd());
+  REQUIRE((ready_events & EPOLLIN) != 0);
+
+  reactor.remove(pipe.first);
+  REQUIRE(reactor.size() == 0);
+  REQUIRE(reactor.poll(0) == 0);
+}
+
+TEST_CASE("test_oneshot") {
+  reactor reactor;
+  auto pipe = make_pipe();
+
+  std::size_t count = 0;
+  reactor.add(pipe.first, EPOLLIN | EPOLLONESHOT, [&](int, unsigned int) {
+    count++;
+  });
+  pipe.second.write('x');
+  REQUIRE(reactor.poll(0) == 1);
+  REQUIRE(reactor.poll(0) == 0); /* disarmed */
+  reactor.modify(pipe.first, EPOLLIN | EPOLLONESHOT);
+  REQUIRE(reactor.poll(0) == 1);
+  REQUIRE(count == 2);
+}
+
+TEST_CASE("test_run") {
+  reactor reactor;
+  auto a = make_pipe();
+  auto b = make_pipe();
+
+  std::string received;
+  const auto reader = [&](const int fd, unsigned int) {
+    char c;
+    descriptor input{fd};
+    input.read(c);
+    input.release();
+    received.push_back(c);
+    reactor.remove(fd == a.first.fd() ? a.first : b.first);
+  };
+  reactor.add(a.first, EPOLLIN, reader);
+  reactor.add(b.first, EPOLLIN, reader);
+  a.second.write('a');
+  b.second.write('b');
+  reactor.run(); /* returns once both callbacks have unregistered */
+  REQUIRE(received.size() == 2);
+}
+
+TEST_CASE("test_reused_fd") {
+  reactor reactor;
+  auto a = make_pipe();
+  const int fd = a.first.fd();
+  bool stale = false;
+  reactor.add(a.first, EPOLLIN, [&](int, unsigned int) { stale = true; });
+  a.first.close(); /* without remove() */
+
+  descriptor reused{::dup(a.second.fd())}; /* takes the lowest free number */
+  REQUIRE(reused.fd() == fd);
+  bool fresh = false;
+  reactor.add(reused, EPOLLOUT, [&](int, unsigned int) { fresh = true; });
+  REQUIRE(reactor.size() == 1);
+  REQUIRE(reactor.poll(0) == 1);
+  REQUIRE(fresh);
+  REQUIRE(!stale);
+  reactor.remove(reused);
+}
+#endif /* __linux__ */
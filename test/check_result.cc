@@ -0,0 +1,52 @@
+/* This is free and unencumbered software released into the public domain. */
+
+#include "catch.hpp"
+
+#include <posix++/error.h>  /* for posix::error */
+#include <posix++/result.h> /* for posix::result */
+
+#include <cerrno>  /* for EAGAIN, ENOENT */
+#include <memory>  /* for std::unique_ptr */
+#include <string>  /* for std::string */
+#include <utility> /* for std::move() */
+
+using namespace posix;
+
+TEST_CASE("test_value") {
+  result<std::string> r{std::string{"hello"}};
+  REQUIRE(r.ok());
+  REQUIRE(static_cast<bool>(r));
+  REQUIRE(!r.error());
+  REQUIRE(*r == "hello");
+  REQUIRE(r->size() == 5);
+  REQUIRE(r.value() == "hello");
+
+  result<std::string> copy{r};
+  REQUIRE(*copy == "hello");
+}
+
+TEST_CASE("test_error") {
+  result<int> r{std::error_code{ENOENT, std::generic_category()}};
+  REQUIRE(!r.ok());
+  REQUIRE(r.error().value() == ENOENT);
+  REQUIRE(r.is(ENOENT));
+  REQUIRE(!r.would_block());
+  REQUIRE(r.value_or(42) == 42);
+  REQUIRE_THROWS_AS(r.value(), const posix::error&);
+
+  errno = EAGAIN;
+  REQUIRE(result<int>::from_errno().would_block());
+}
+
+TEST_CASE("test_move_only") {
+  result<std::unique_ptr<int>> r{std::unique_ptr<int>{new int{7}}};
+  REQUIRE(**r == 7);
+  result<std::unique_ptr<int>> moved{std::move(r)};
+  REQUIRE(**moved == 7);
+
+  std::unique_ptr<int> value = std::move(moved).value();
+  REQUIRE(*value == 7);
+
+  moved = result<std::unique_ptr<int>>{std::error_code{EAGAIN, std::generic_category()}};
+  REQUIRE(moved.would_block());
+}
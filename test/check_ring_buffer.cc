@@ -0,0 +1,72 @@
+/* This is free and unencumbered software released into the public domain. */
+
+#include "catch.hpp"
+#include "helpers.h"
+
+#include <posix++/descriptor.h>  /* for posix::descriptor */
+#include <posix++/ring_buffer.h> /* for posix::ring_buffer */
+
+#include <cstring>  /* for std::memcpy(), std::memset() */
+#include <string>   /* for std::string */
+#include <unistd.h> /* for sysconf() */
+
+using namespace posix;
+
+TEST_CASE("test_capacity") {
+  const auto page_size = static_cast<std::size_t>(::sysconf(_SC_PAGE_SIZE));
+  ring_buffer buffer{1};
+  REQUIRE(buffer.capacity() == page_size);
+  REQUIRE(buffer.empty());
+  REQUIRE(buffer.available() == page_size);
+}
+
+TEST_CASE("test_wraparound") {
+  ring_buffer buffer{1};
+  const std::size_t capacity = buffer.capacity();
+
+  /* Move the head close to the end of the buffer: */
+  std::memset(buffer.tail(), 'x', capacity - 3);
+  buffer.commit(capacity - 3);
+  buffer.consume(capacity - 3);
+  REQUIRE(buffer.empty());
+
+  /* Write across the wrap point through a single pointer: */
+  REQUIRE(buffer.available() == capacity);
+  std::memcpy(buffer.tail(), "Hello, world!", 13);
+  buffer.commit(13);
+  REQUIRE(buffer.size() == 13);
+  REQUIRE(std::string(reinterpret_cast<const char*>(buffer.data()), buffer.size()) == "Hello, world!");
+
+  buffer.consume(7);
+  REQUIRE(std::string(reinterpret_cast<const char*>(buffer.data()), buffer.size()) == "world!");
+
+  std::memset(buffer.tail(), 'y', buffer.available());
+  buffer.commit(buffer.available());
+  REQUIRE(buffer.full());
+  REQUIRE(buffer.data()[buffer.size() - 1] == 'y');
+
+  buffer.clear();
+  REQUIRE(buffer.empty());
+}
+
+TEST_CASE("test_read_from") {
+  auto pipe = make_pipe();
+  descriptor& input = pipe.first;
+  descriptor& output = pipe.second;
+
+  ring_buffer buffer{1};
+  buffer.commit(buffer.capacity() - 2);
+  buffer.consume(buffer.capacity() - 2);
+
+  output.write(std::string{"abcdef"});
+  REQUIRE(buffer.read_from(input) == 6);
+  REQUIRE(std::string(reinterpret_cast<const char*>(buffer.data()), buffer.size()) == "abcdef");
+
+  REQUIRE(buffer.write_to(output) == 6);
+  REQUIRE(buffer.empty());
+  REQUIRE(buffer.read_from(input) == 6);
+  REQUIRE(buffer.size() == 6);
+
+  output.close();
+  REQUIRE(buffer.read_from(input) == 0);
+}
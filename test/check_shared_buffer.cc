@@ -0,0 +1,56 @@
+/* This is free and unencumbered software released into the public domain. */
+
+#include "catch.hpp"
+
+#include <posix++/error.h>         /* for posix::error */
+#include <posix++/shared_buffer.h> /* for posix::shared_buffer */
+
+#include <cstring>    /* for std::memcmp(), std::memcpy() */
+#include <fcntl.h>    /* for F_SEAL_* */
+#include <sys/mman.h> /* for PROT_* */
+
+using namespace posix;
+
+#ifdef F_ADD_SEALS
+TEST_CASE("test_create") {
+  auto buffer = shared_buffer::create(1024 * 1024);
+  REQUIRE(buffer.valid());
+  REQUIRE(buffer.cloexec());
+  REQUIRE(buffer.size() == 1024 * 1024);
+  REQUIRE(buffer.seals() == 0);
+  REQUIRE(buffer.map()[1024 * 1024 - 1] == 0);
+}
+
+TEST_CASE("test_seal") {
+  auto buffer = shared_buffer::create(4096);
+  {
+    auto mapping = buffer.map(PROT_READ | PROT_WRITE);
+    std::memcpy(mapping.data(), "Hello", 5);
+  }
+  buffer.seal(F_SEAL_SHRINK | F_SEAL_GROW);
+  REQUIRE(buffer.sealed(F_SEAL_SHRINK | F_SEAL_GROW));
+  REQUIRE(!buffer.sealed(F_SEAL_WRITE));
+  REQUIRE_THROWS_AS(buffer.truncate(0), const posix::error&);
+
+  buffer.seal(F_SEAL_WRITE | F_SEAL_SEAL);
+  REQUIRE(buffer.sealed(F_SEAL_WRITE | F_SEAL_SEAL));
+  REQUIRE_THROWS_AS(buffer.map(PROT_READ | PROT_WRITE), const posix::error&);
+  REQUIRE_THROWS_AS(buffer.seal(F_SEAL_GROW), const posix::error&);
+  REQUIRE(std::memcmp(buffer.map().data(), "Hello", 5) == 0);
+}
+
+TEST_CASE("test_seal_future_write") {
+  auto buffer = shared_buffer::create(4096);
+  auto mapping = buffer.map(PROT_READ | PROT_WRITE);
+  REQUIRE_THROWS_AS(buffer.seal(F_SEAL_WRITE), const posix::error&); /* EBUSY */
+  try {
+    buffer.seal(F_SEAL_FUTURE_WRITE);
+  }
+  catch (const posix::invalid_argument&) {
+    return; /* Linux < 5.1 */
+  }
+  std::memcpy(mapping.data(), "Hello", 5); /* still writable */
+  REQUIRE_THROWS_AS(buffer.map(PROT_READ | PROT_WRITE), const posix::error&);
+  REQUIRE(std::memcmp(buffer.map().data(), "Hello", 5) == 0);
+}
+#endif /* F_ADD_SEALS */
@@ -0,0 +1,64 @@
+/* This is free and unencumbered software released into the public domain. */
+
+#include "catch.hpp"
+#include "helpers.h"
+
+#include <posix++/descriptor.h> /* for posix::descriptor */
+#include <posix++/splice.h>     /* for posix::splice(), posix::tee(), posix::vmsplice() */
+
+#include <fcntl.h>   /* for SPLICE_F_* */
+#include <sys/uio.h> /* for struct iovec */
+#include <unistd.h>  /* for lseek() */
+
+using namespace posix;
+
+#ifdef __linux__
+TEST_CASE("test_splice") {
+  auto pipe = make_pipe();
+  auto file = make_temporary_file();
+  pipe.second.write("Hello, world!");
+  REQUIRE(posix::splice(pipe.first, file, 5, SPLICE_F_MOVE) == 5);
+  REQUIRE(::lseek(file.fd(), 0, SEEK_CUR) == 5);
+}
+
+TEST_CASE("test_tee") {
+  auto source = make_pipe();
+  auto copy = make_pipe();
+  source.second.write("Hello");
+  source.second.close();
+  REQUIRE(posix::tee(source.first, copy.second, 5, SPLICE_F_NONBLOCK) == 5);
+  copy.second.close();
+  REQUIRE(source.first.read() == "Hello");
+  REQUIRE(copy.first.read() == "Hello");
+}
+
+TEST_CASE("test_vmsplice") {
+  auto pipe = make_pipe();
+  char data[] = "Hello";
+  const struct iovec iov[1] = {{data, 5}};
+  REQUIRE(posix::vmsplice(pipe.second, iov, 1) == 5);
+  pipe.second.close();
+  REQUIRE(pipe.first.read() == "Hello");
+}
+#endif /* __linux__ */
+
+TEST_CASE("test_transfer_pipe_to_file") {
+  auto pipe = make_pipe();
+  auto file = make_temporary_file();
+  pipe.second.write("Hello, world!");
+  pipe.second.close();
+  REQUIRE(pipe.first.transfer_to(file) == 13);
+  ::lseek(file.fd(), 0, SEEK_SET);
+  REQUIRE(file.read() == "Hello, world!");
+}
+
+TEST_CASE("test_transfer_file_to_file") {
+  auto source = make_temporary_file();
+  auto target = make_temporary_file();
+  source.write("Hello, world!");
+  ::lseek(source.fd(), 0, SEEK_SET);
+  REQUIRE(source.transfer_to(target, 5) == 5);
+  REQUIRE(source.transfer_to(target) == 8);
+  ::lseek(target.fd(), 0, SEEK_SET);
+  REQUIRE(target.read() == "Hello, world!");
+}
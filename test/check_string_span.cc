@@ -0,0 +1,40 @@
+/* This is free and unencumbered software released into the public domain. */
+
+#include "catch.hpp"
+
+#include <posix++/string_span.h> /* for posix::string_span, posix::string_split */
+
+#include <string> /* for std::string */
+#include <vector> /* for std::vector */
+
+using namespace posix;
+
+static std::vector<std::string>
+split(const std::string& input, const char separator) {
+  std::vector<std::string> result;
+  for (const auto& record : string_split{input.data(), input.size(), separator}) {
+    result.push_back(record.str());
+  }
+  return result;
+}
+
+TEST_CASE("test_string_span") {
+  const std::string hello{"Hello, world!"};
+  const string_span span{hello};
+  REQUIRE(span.size() == 13);
+  REQUIRE(span[0] == 'H');
+  REQUIRE(span == string_span{"Hello, world!"});
+  REQUIRE(span != string_span{"Hello"});
+  REQUIRE(span.str() == hello);
+  REQUIRE(string_span{}.empty());
+  REQUIRE(string_span{} == string_span{""});
+}
+
+TEST_CASE("test_string_split") {
+  REQUIRE(split("", '\n').empty());
+  REQUIRE(split("a", '\n') == (std::vector<std::string>{"a"}));
+  REQUIRE(split("a\n", '\n') == (std::vector<std::string>{"a"}));
+  REQUIRE(split("a\nbc\n\nd", '\n') == (std::vector<std::string>{"a", "bc", "", "d"}));
+  REQUIRE(split("\n", '\n') == (std::vector<std::string>{""}));
+  REQUIRE(split("a,b", ',') == (std::vector<std::string>{"a", "b"}));
+}
@@ -2,7 +2,10 @@
 
 #include "catch.hpp"
 
-#include <posix++/sysv_segment.h> /* for posix::sysv_segment */
+#include <posix++/error.h>          /* for posix::error */
+#include <posix++/memory_mapping.h> /* for posix::memory_mapping */
+#include <posix++/numa_policy.h>    /* for posix::numa_policy */
+#include <posix++/sysv_segment.h>   /* for posix::sysv_segment */
 
 #include <unistd.h> /* for getpagesize(), getpid() */
 
@@ -17,3 +20,28 @@ TEST_CASE("test_sysv_segment") {
   REQUIRE(!shm.is_attached());
   shm.remove();
 }
+
+TEST_CASE("test_numa_policy") {
+  sysv_segment shm = sysv_segment::create_unique(getpagesize(), 0600);
+  shm.attach();
+  shm.set_numa_policy(numa_policy::interleave());
+  shm.data()[0] = 42;
+  REQUIRE(shm.numa_placement().size() == 1);
+  shm.detach();
+  shm.remove();
+}
+
+#ifdef SHM_HUGETLB
+TEST_CASE("test_hugetlb") {
+  const std::size_t page_size = memory_mapping::huge_page_size();
+  if (!page_size) return;
+  try {
+    sysv_segment shm = sysv_segment::create_unique(1, 0600 | SHM_HUGETLB);
+    REQUIRE(shm.size() == page_size);
+    shm.remove();
+  }
+  catch (const posix::error&) {
+    /* The huge page pool is exhausted, or we lack the privileges. */
+  }
+}
+#endif
@@ -0,0 +1,87 @@
+/* This is free and unencumbered software released into the public domain. */
+
+#include "catch.hpp"
+#include "helpers.h"
+
+#include <posix++/error.h>                /* for posix::error */
+#include <posix++/pathname.h>             /* for posix::pathname */
+#include <posix++/windowed_mapped_file.h> /* for posix::windowed_mapped_file */
+
+#include <fcntl.h>  /* for O_RDONLY */
+#include <string>   /* for std::string */
+#include <unistd.h> /* for sysconf(), unlink() */
+
+using namespace posix;
+
+static windowed_mapped_file
+make_windowed_mapped_file(const std::string& contents) {
+  const auto pathname = make_temporary_path(contents);
+  /* Use the smallest possible window, so that most records straddle: */
+  windowed_mapped_file result = windowed_mapped_file::open(pathname, O_RDONLY, 0, 1);
+  ::unlink(pathname.c_str());
+  return result;
+}
+
+static std::string
+make_contents() {
+  std::string contents;
+  for (int i = 0; contents.size() < 256 * 1024; i++) {
+    contents.append(std::to_string(i * 7919)).push_back('\n');
+  }
+  return contents;
+}
+
+TEST_CASE("test_window_size") {
+  const auto page_size = static_cast<std::size_t>(::sysconf(_SC_PAGE_SIZE));
+  auto file = make_windowed_mapped_file("x");
+  REQUIRE(file.window_size() == page_size);
+  REQUIRE(file.size() == 1);
+}
+
+TEST_CASE("test_read_line") {
+  const auto contents = make_contents();
+  auto file = make_windowed_mapped_file(contents);
+  REQUIRE(file.size() == contents.size());
+
+  std::string result, line;
+  while (file.read_line(line)) {
+    result.append(line).push_back('\n');
+    line.clear();
+  }
+  REQUIRE(result == contents);
+  REQUIRE(file.is_eof());
+}
+
+TEST_CASE("test_read") {
+  const auto contents = make_contents();
+  auto file = make_windowed_mapped_file(contents);
+
+  /* Read across several window edges at once: */
+  std::string buffer(3 * file.window_size() + 17, '\0');
+  REQUIRE(file.read(&buffer[0], buffer.size()) == buffer.size());
+  REQUIRE(buffer == contents.substr(0, buffer.size()));
+
+  char c;
+  REQUIRE(file.read(c) == 1);
+  REQUIRE(c == contents[buffer.size()]);
+
+  REQUIRE(file.read() == contents.substr(buffer.size() + 1));
+  REQUIRE(file.read(c) == 0);
+}
+
+TEST_CASE("test_seek") {
+  const auto contents = make_contents();
+  auto file = make_windowed_mapped_file(contents);
+
+  const std::size_t offset = 5 * file.window_size() - 2;
+  REQUIRE(file.seek(offset) == offset);
+  std::string buffer(4, '\0');
+  REQUIRE(file.read(&buffer[0], buffer.size()) == 4);
+  REQUIRE(buffer == contents.substr(offset, 4));
+
+  REQUIRE(file.seek(-4, SEEK_CUR) == offset);
+  REQUIRE(file.seek(-1, SEEK_END) == contents.size() - 1);
+  file.rewind();
+  REQUIRE(file.offset() == 0);
+  REQUIRE_THROWS_AS(file.seek(-1, SEEK_SET), const posix::error&);
+}
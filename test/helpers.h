@@ -0,0 +1,85 @@
+/* This is free and unencumbered software released into the public domain. */
+
+#ifndef POSIXXX_TEST_HELPERS_H
+#define POSIXXX_TEST_HELPERS_H
+
+/* Fixtures shared by the test programs; include after "catch.hpp". */
+
+#include <posix++/descriptor.h> /* for posix::descriptor */
+
+#include <cstddef>   /* for std::size_t */
+#include <cstdlib>   /* for mkstemp() */
+#include <string>    /* for std::string */
+#include <unistd.h>  /* for ftruncate(), pipe(), unlink() */
+#include <utility>   /* for std::pair */
+
+/**
+ * Returns a new pipe, as its read and write ends.
+ */
+static inline std::pair<posix::descriptor, posix::descriptor>
+make_pipe() {
+  int fds[2];
+  REQUIRE(::pipe(fds) == 0);
+  return std::pair<posix::descriptor, posix::descriptor>{
+    posix::descriptor{fds[0]}, posix::descriptor{fds[1]}};
+}
+
+/**
+ * Returns a new pipe holding the given contents, with its write end
+ * already closed.
+ */
+static inline std::pair<posix::descriptor, posix::descriptor>
+make_pipe(const std::string& contents) {
+  auto pipe = make_pipe();
+  pipe.second.write(contents);
+  pipe.second.close();
+  return pipe;
+}
+
+/**
+ * Returns a new, empty, already unlinked temporary file.
+ */
+static inline posix::descriptor
+make_temporary_file() {
+  char pathname[] = "/tmp/check_posix++.XXXXXX";
+  posix::descriptor result{::mkstemp(pathname)};
+  REQUIRE(result.valid());
+  ::unlink(pathname);
+  return result;
+}
+
+/**
+ * Returns a new, unlinked temporary file of the given size.
+ */
+static inline posix::descriptor
+make_temporary_file(const std::size_t size) {
+  auto result = make_temporary_file();
+  REQUIRE(::ftruncate(result.fd(), static_cast<off_t>(size)) == 0);
+  return result;
+}
+
+/**
+ * Returns a new, unlinked temporary file holding the given contents,
+ * with its file offset at the end.
+ */
+static inline posix::descriptor
+make_temporary_file(const std::string& contents) {
+  auto result = make_temporary_file();
+  result.write(contents);
+  return result;
+}
+
+/**
+ * Creates a new temporary file holding the given contents, and returns
+ * its pathname. The caller is responsible for unlinking it.
+ */
+static inline std::string
+make_temporary_path(const std::string& contents = std::string{}) {
+  char pathname[] = "/tmp/check_posix++.XXXXXX";
+  posix::descriptor output{::mkstemp(pathname)};
+  REQUIRE(output.valid());
+  output.write(contents);
+  return pathname;
+}
+
+#endif /* POSIXXX_TEST_HELPERS_H */